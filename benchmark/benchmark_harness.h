@@ -0,0 +1,195 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/**
+ * @file benchmark_harness.h
+ *
+ * @brief Minimal self-timing benchmark runner reporting ns/op, bytes/s and allocations/op.
+ */
+#pragma once
+
+// System includes
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Internal includes
+#include "allocation_counter.h"
+
+namespace mmt {
+namespace au2mhasconverterlib {
+namespace benchmark {
+//! Prevents the compiler from optimizing away the computation of @p value.
+template <class T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "g"(&value) : "memory");
+#else
+  const volatile void* sink = &value;
+  (void)sink;
+#endif
+}
+
+//! Result of a single benchmark case.
+struct SBenchmarkResult {
+  std::string name;
+  uint64_t iterations = 0;
+  double nsPerOp = 0.0;
+  double bytesPerSecond = 0.0;
+  double allocsPerOp = 0.0;
+};
+
+//! Runs benchmark cases until the minimal measurement time is reached and collects the results.
+class CBenchmarkRunner {
+ public:
+  struct SConfig {
+    //! Only cases whose name contains this string are run (empty runs all).
+    std::string filter;
+    //! Minimal duration of the measured batch of each case in milliseconds.
+    uint64_t minTimeMs = 200;
+  };
+
+  explicit CBenchmarkRunner(const SConfig& config) : m_config(config) {}
+
+  /*!
+   * @brief Measures @p op.
+   *
+   * @p bytesPerOp is the number of input bytes processed by one call of @p op, it is used to
+   * calculate the throughput. The iteration count is doubled (or extrapolated) until one batch
+   * takes at least the configured minimal time, only this last batch is reported.
+   */
+  template <class Op>
+  void run(const std::string& name, uint64_t bytesPerOp, Op&& op) {
+    if (!m_config.filter.empty() && name.find(m_config.filter) == std::string::npos) {
+      return;
+    }
+
+    // warm up caches and lazily allocated buffers
+    op();
+
+    const uint64_t minTimeNs = m_config.minTimeMs * 1000000u;
+    uint64_t iterations = 1;
+    for (;;) {
+      const uint64_t allocationsBefore = verification::allocationCount().allocations;
+      const auto start = std::chrono::steady_clock::now();
+      for (uint64_t i = 0; i < iterations; ++i) {
+        op();
+      }
+      const uint64_t elapsedNs = static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                               start)
+              .count());
+      const uint64_t allocations = verification::allocationCount().allocations - allocationsBefore;
+
+      if (elapsedNs >= minTimeNs) {
+        SBenchmarkResult result;
+        result.name = name;
+        result.iterations = iterations;
+        result.nsPerOp = static_cast<double>(elapsedNs) / static_cast<double>(iterations);
+        result.bytesPerSecond = static_cast<double>(bytesPerOp) * 1e9 / result.nsPerOp;
+        result.allocsPerOp = static_cast<double>(allocations) / static_cast<double>(iterations);
+        m_results.push_back(result);
+        return;
+      }
+
+      // extrapolate with some headroom, but at least double the iterations
+      uint64_t next = elapsedNs == 0 ? iterations * 100
+                                     : iterations * minTimeNs / elapsedNs * 12 / 10;
+      iterations = next > iterations * 2 ? next : iterations * 2;
+    }
+  }
+
+  //! Returns the results of all cases run so far.
+  const std::vector<SBenchmarkResult>& results() const { return m_results; }
+
+  //! Prints the results as a table.
+  void print(std::ostream& stream) const;
+
+ private:
+  SConfig m_config;
+  std::vector<SBenchmarkResult> m_results;
+};
+}  // namespace benchmark
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
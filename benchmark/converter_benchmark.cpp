@@ -0,0 +1,296 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// System includes
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// External includes
+#include "ilo/bitbuffer.h"
+#include "ilo/bitparser.h"
+#include "mmtisobmff/types.h"
+#include "mmtmhasparserlib/mhasutilities.h"
+
+// Internal includes
+#include "mmtau2mhasconverterlib/converter.h"
+#include "mmtau2mhasconverterlib/file_converter.h"
+#include "mmtau2mhasconverterlib/log_redirect.h"
+#include "benchmark_harness.h"
+#include "bitstream_builder.h"
+#include "converter_mhm.h"
+#include "mhas_scan.h"
+
+using namespace mmt::au2mhasconverterlib;
+using namespace mmt::au2mhasconverterlib::benchmark;
+using namespace mmt::au2mhasconverterlib::generator;
+
+static constexpr size_t FRAME_SIZE = 768;
+static constexpr size_t PRE_ROLL_SIZE = 768;
+
+static void printUsage() {
+  std::cout << "Usage: au2mhasbenchmark [options]" << std::endl;
+  std::cout << "Options:" << std::endl;
+  std::cout << "  -f <text>  (Optional) Only run benchmarks whose name contains <text>"
+            << std::endl;
+  std::cout << "  -t <ms>    (Optional) Minimal measurement time per benchmark, default 200 ms"
+            << std::endl;
+}
+
+static void benchmarkConvertConfig(CBenchmarkRunner& runner) {
+  struct SNamedShape {
+    const char* name;
+    SConfigShape shape;
+  };
+  std::vector<SNamedShape> shapes(5);
+  shapes[0].name = "convertConfig/channels";
+  shapes[1].name = "convertConfig/objects";
+  shapes[1].shape.numChannelGroups = 0;
+  shapes[1].shape.numObjectGroups = 4;
+  shapes[1].shape.objectsPerGroup = 4;
+  shapes[2].name = "convertConfig/channels+objects";
+  shapes[2].shape.numObjectGroups = 2;
+  shapes[2].shape.objectsPerGroup = 8;
+  shapes[3].name = "convertConfig/many_ext_elements";
+  shapes[3].shape.numExtElements = 32;
+  shapes[3].shape.extElementConfigSize = 32;
+  shapes[4].name = "convertConfig/large_asi";
+  shapes[4].shape.asiSize = 4096;
+
+  for (const auto& shape : shapes) {
+    const ByteBuffer config = buildConfig(shape.shape);
+    CConverter converter(CConverter::SConverterConfiguration{});
+    runner.run(shape.name, config.size(), [&] {
+      SMhasConfigOutput output = converter.convertConfig(config);
+      doNotOptimize(output);
+    });
+  }
+}
+
+static void benchmarkConvertFrame(CBenchmarkRunner& runner) {
+  const ByteBuffer config = buildConfig(SConfigShape{});
+  const ByteBuffer frame = buildFrame(FRAME_SIZE, false);
+  const ByteBuffer ipfWithConfig = buildIpf(config, PRE_ROLL_SIZE, FRAME_SIZE);
+  const ByteBuffer ipfWithoutConfig = buildIpf(ByteBuffer{}, PRE_ROLL_SIZE, FRAME_SIZE);
+
+  CConverter converter(CConverter::SConverterConfiguration{});
+  converter.convertConfig(config);
+
+  runner.run("convertFrame/regular", frame.size(), [&] {
+    SMhasFrameOutput output = converter.convertFrame(frame);
+    doNotOptimize(output);
+  });
+  runner.run("convertIPF/embedded_config", ipfWithConfig.size(), [&] {
+    SMhasFrameOutput output = converter.convertFrame(ipfWithConfig);
+    doNotOptimize(output);
+  });
+  runner.run("convertIPF/no_config", ipfWithoutConfig.size(), [&] {
+    SMhasFrameOutput output = converter.convertFrame(ipfWithoutConfig);
+    doNotOptimize(output);
+  });
+}
+
+static void benchmarkEscapedValues(CBenchmarkRunner& runner) {
+  // mix of values hitting all three escape stages of (4, 8, 16)
+  std::vector<uint64_t> values(1024);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = (i % 3 == 0) ? i % 15 : (i % 3 == 1) ? 15 + i % 255 : 270 + i * 13;
+  }
+
+  ilo::CBitBuffer encoded;
+  for (uint64_t value : values) {
+    mmt::mhasparserlib::writeEscapedValue(encoded, value, 4, 8, 16);
+  }
+  encoded.byteAlign();
+  const ByteBuffer encodedBuffer = encoded.bytebuffer();
+
+  runner.run("escapedValue/write", encodedBuffer.size(), [&] {
+    ilo::CBitBuffer writer;
+    for (uint64_t value : values) {
+      mmt::mhasparserlib::writeEscapedValue(writer, value, 4, 8, 16);
+    }
+    doNotOptimize(writer);
+  });
+  runner.run("escapedValue/read", encodedBuffer.size(), [&] {
+    ilo::CBitParser parser(encodedBuffer);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+      sum += mmt::mhasparserlib::readEscapedValue(parser, 4, 8, 16);
+    }
+    doNotOptimize(sum);
+  });
+}
+
+static void benchmarkCleanMhmSample(CBenchmarkRunner& runner) {
+  const ByteBuffer config = buildConfig(SConfigShape{});
+  const ByteBuffer frame = buildFrame(FRAME_SIZE, false);
+  const ByteBuffer ipf = buildIpf(ByteBuffer{}, PRE_ROLL_SIZE, FRAME_SIZE);
+
+  CFileConverter::SConfig fileConfig;
+  mmt::isobmff::CSample regularSample;
+  regularSample.rawData = buildMhmSample(ByteBuffer{}, frame, false, 1);
+  mmt::isobmff::CSample configSample;
+  configSample.rawData = buildMhmSample(config, ipf, true, 1);
+
+  auto converter = openMhmConverter(1);
+  CMhmSampleCleaner cleaner(fileConfig, *converter);
+  mmt::isobmff::CSample output;
+  uint64_t sampleIndex = 0;
+  runner.run("cleanMhmSample/frame", regularSample.rawData.size(), [&] {
+    cleaner.clean(regularSample, sampleIndex++, output);
+    doNotOptimize(output);
+  });
+  runner.run("cleanMhmSample/config+ipf", configSample.rawData.size(), [&] {
+    cleaner.clean(configSample, sampleIndex++, output);
+    doNotOptimize(output);
+  });
+}
+
+static void benchmarkMhasScan(CBenchmarkRunner& runner) {
+  const ByteBuffer config = buildConfig(SConfigShape{});
+  const ByteBuffer frame = buildFrame(FRAME_SIZE, false);
+
+  // a raw MHAS stream with a sync and config packet every 50 frames
+  ByteBuffer stream;
+  for (size_t i = 0; i < 500; ++i) {
+    const bool isIpf = i % 50 == 0;
+    const ByteBuffer sample = buildMhmSample(isIpf ? config : ByteBuffer{}, frame, isIpf, 1);
+    stream.insert(stream.end(), sample.begin(), sample.end());
+  }
+
+  std::vector<SMhasPacketHeader> packets;
+  runner.run("scanMhasPackets/stream", stream.size(), [&] {
+    bool complete = scanMhasPackets(stream.data(), stream.size(), packets);
+    doNotOptimize(complete);
+  });
+}
+
+int main(int argc, char* argv[]) {
+  CBenchmarkRunner::SConfig config;
+  for (int i = 1; i < argc; i += 2) {
+    const std::string argument = argv[i];
+    if (argument == "-h" || argument == "--help") {
+      printUsage();
+      return EXIT_SUCCESS;
+    }
+    if (i + 1 >= argc) {
+      std::cout << "Missing value for command line parameter: " << argument << std::endl;
+      printUsage();
+      return EXIT_FAILURE;
+    }
+    if (argument == "-f") {
+      config.filter = argv[i + 1];
+    } else if (argument == "-t") {
+      try {
+        config.minTimeMs = std::stoul(argv[i + 1]);
+      } catch (const std::exception&) {
+        std::cout << "The minimal time needs to be a numerical value, got: " << argv[i + 1]
+                  << std::endl;
+        printUsage();
+        return EXIT_FAILURE;
+      }
+    } else {
+      std::cout << "Invalid command line parameter: " << argument << std::endl;
+      printUsage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  // logging would dominate the measurements
+  logging::disable();
+
+  CBenchmarkRunner runner(config);
+  try {
+    benchmarkConvertConfig(runner);
+    benchmarkConvertFrame(runner);
+    benchmarkEscapedValues(runner);
+    benchmarkCleanMhmSample(runner);
+    benchmarkMhasScan(runner);
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  runner.print(std::cout);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,480 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// System includes
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// External includes
+#include "ilo/logging.h"
+
+// Internal includes
+#include "mmtau2mhasconverterlib/directory_converter.h"
+#include "mmtau2mhasconverterlib/file_converter.h"
+#include "mmtau2mhasconverterlib/log_redirect.h"
+#include "directories.h"
+#include "json_values.h"
+#include "mp4_generator.h"
+#include "system_metrics.h"
+
+using namespace mmt::au2mhasconverterlib;
+using namespace mmt::au2mhasconverterlib::benchmark;
+using namespace mmt::au2mhasconverterlib::generator;
+
+static constexpr uint64_t DIRECTORY_FILE_DURATION_SEC = 60;
+//! The tolerance of a scenario is this multiple of the spread measured when recording the baseline
+static constexpr double SPREAD_TOLERANCE_FACTOR = 2.0;
+static constexpr double MIN_TOLERANCE = 0.05;
+static constexpr double MAX_TOLERANCE = 0.5;
+//! Repetitions needed to measure a spread when recording a baseline
+static constexpr uint32_t MIN_BASELINE_REPETITIONS = 3;
+
+#if !defined(AU2MHAS_BUILD_FLAGS)
+#define AU2MHAS_BUILD_FLAGS "unknown"
+#endif
+
+struct SInput {
+  std::vector<std::string> files;
+  uint64_t bytes = 0;
+  uint64_t samples = 0;
+};
+
+struct SScenarioResult {
+  std::string name;
+  double mbPerSec = 0.0;
+  double samplesPerSec = 0.0;
+  double peakRssMiB = 0.0;
+  bool coldCache = false;
+  // relative spread of the repetitions: 1 - fastest / slowest run time
+  double spread = 0.0;
+  // per-stage wall times of the fastest run (file scenarios only)
+  double openMs = 0.0;
+  double readMs = 0.0;
+  double convertMs = 0.0;
+  double writeMs = 0.0;
+};
+
+static void printUsage() {
+  std::cout << "Usage: au2mhase2ebenchmark [options] -o <work directory>" << std::endl;
+  std::cout << "Options:" << std::endl;
+  std::cout << "  -d <sec>   (Optional) Duration of the single file inputs, default 600"
+            << std::endl;
+  std::cout << "  -n <num>   (Optional) Number of 60 s files of the directory input, default 16"
+            << std::endl;
+  std::cout << "  -r <num>   (Optional) Repetitions per scenario (the fastest counts), default 3"
+            << std::endl;
+  std::cout << "  -j <path>  (Optional) Write the results as JSON" << std::endl;
+  std::cout << "  -b <path>  (Optional) Compare against the baseline JSON, exit code 1 on "
+               "regression"
+            << std::endl;
+  std::cout << "  -u <path>  (Optional) Record the measured values as new baseline JSON (needs at "
+               "least "
+            << MIN_BASELINE_REPETITIONS << " repetitions)" << std::endl;
+}
+
+static double toMs(uint64_t ns) {
+  return static_cast<double>(ns) / 1e6;
+}
+
+static SInput generateInput(const std::string& directory, const std::string& baseName,
+                            EContainerFormat format, uint64_t numFiles, uint64_t durationSec) {
+  ILO_ASSERT(CDirectories::createDirectory(directory) !=
+                 CDirectories::ECreateDirectoryReturn::FAILED,
+             "Creating %s failed", directory.c_str());
+  SInput input;
+  for (uint64_t k = 0; k < numFiles; ++k) {
+    SStreamConfig streamConfig;
+    SMp4Config mp4Config;
+    streamConfig.seed = k + 1;
+    streamConfig.numFrames = durationSec * mp4Config.sampleRate / mp4Config.frameLength;
+    mp4Config.format = format;
+    mp4Config.outputFile =
+        directory + CDirectories::getPathSeparator() + baseName + std::to_string(k) + ".mp4";
+    SMp4Statistics statistics = writeMp4File(streamConfig, mp4Config);
+    input.files.push_back(mp4Config.outputFile);
+    input.bytes += CDirectories::getFileSize(mp4Config.outputFile);
+    input.samples += statistics.samples;
+  }
+  return input;
+}
+
+static bool evictInput(const SInput& input) {
+  bool success = true;
+  for (const auto& file : input.files) {
+    success = dropFromPageCache(file) && success;
+  }
+  return success;
+}
+
+template <class Run>
+static SScenarioResult measure(const std::string& name, const SInput& input, bool coldCache,
+                               uint32_t repetitions, Run&& run) {
+  SScenarioResult result;
+  result.name = name + (coldCache ? "_cold" : "_warm");
+  result.coldCache = coldCache;
+
+  if (!coldCache) {
+    // populate the page cache
+    run(result);
+  }
+
+  double bestSec = 0.0;
+  double worstSec = 0.0;
+  for (uint32_t i = 0; i < repetitions; ++i) {
+    if (coldCache && !evictInput(input)) {
+      std::cout << "Evicting the page cache is not supported, " << result.name << " is warm"
+                << std::endl;
+      coldCache = false;
+    }
+    SScenarioResult runResult = result;
+    const auto start = std::chrono::steady_clock::now();
+    run(runResult);
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (i == 0 || seconds < bestSec) {
+      bestSec = seconds;
+      result = runResult;
+    }
+    worstSec = std::max(worstSec, seconds);
+  }
+
+  result.mbPerSec = static_cast<double>(input.bytes) / 1e6 / bestSec;
+  result.samplesPerSec = static_cast<double>(input.samples) / bestSec;
+  result.spread = 1.0 - bestSec / worstSec;
+  // note: high-water mark of the whole process up to and including this scenario
+  result.peakRssMiB = static_cast<double>(peakRssBytes()) / (1024.0 * 1024.0);
+  return result;
+}
+
+static SScenarioResult runFileScenario(const std::string& name, const SInput& input,
+                                       const std::string& outputFile, bool coldCache,
+                                       uint32_t repetitions) {
+  return measure(name, input, coldCache, repetitions, [&](SScenarioResult& result) {
+    CFileConverter::SConfig config;
+    config.inputFile = input.files.front();
+    config.outputFile = outputFile;
+    CFileConverter converter(config);
+    converter.process();
+
+    const SFileConversionStatistics& statistics = converter.statistics();
+    result.openMs = toMs(statistics.openNs);
+    result.readMs = toMs(statistics.readNs);
+    result.convertMs = toMs(statistics.convertNs);
+    result.writeMs = toMs(statistics.writeNs);
+  });
+}
+
+static SScenarioResult runDirectoryScenario(const std::string& name, const SInput& input,
+                                            const std::string& inputDirectory,
+                                            const std::string& outputDirectory, bool coldCache,
+                                            uint32_t repetitions) {
+  return measure(name, input, coldCache, repetitions, [&](SScenarioResult&) {
+    CDirectoryConverter::SConfig config;
+    config.inputDirectoryPath = inputDirectory;
+    config.outputDirectoryPath = outputDirectory;
+    config.replaceFiles = true;
+    CDirectoryConverter converter(config);
+    converter.process();
+  });
+}
+
+static void printResults(const std::vector<SScenarioResult>& results) {
+  std::printf("%-24s %10s %12s %12s %10s %10s %10s %10s\n", "scenario", "MB/s", "samples/s",
+              "peakRSS MiB", "open ms", "read ms", "conv ms", "write ms");
+  for (const auto& result : results) {
+    std::printf("%-24s %10.2f %12.0f %12.1f %10.1f %10.1f %10.1f %10.1f\n", result.name.c_str(),
+                result.mbPerSec, result.samplesPerSec, result.peakRssMiB, result.openMs,
+                result.readMs, result.convertMs, result.writeMs);
+  }
+}
+
+static double toleranceFromSpread(double spread) {
+  return std::min(MAX_TOLERANCE, std::max(MIN_TOLERANCE, SPREAD_TOLERANCE_FACTOR * spread));
+}
+
+static std::string compilerDescription() {
+#if defined(__clang__)
+  return "clang " __clang_version__;
+#elif defined(__GNUC__)
+  return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+  return "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+  return "unknown compiler";
+#endif
+}
+
+static std::string jsonString(const std::string& text) {
+  std::string result = "\"";
+  for (char character : text) {
+    if (character == '"' || character == '\\') {
+      result += '\\';
+    }
+    result += character;
+  }
+  return result + "\"";
+}
+
+static void writeResults(const std::string& path, const std::vector<SScenarioResult>& results,
+                         uint32_t repetitions, bool asBaseline) {
+  std::ofstream file(path);
+  ILO_ASSERT(file.good(), "Opening %s failed", path.c_str());
+  file << "{\n";
+  if (asBaseline) {
+    file << "  \"comment\": " << jsonString(
+                                     "Recorded by au2mhase2ebenchmark -u. The tolerance of each "
+                                     "scenario is derived from the spread of its repetitions.")
+         << ",\n";
+  }
+  file << "  \"machine\": " << jsonString(machineDescription()) << ",\n";
+  file << "  \"compiler\": " << jsonString(compilerDescription()) << ",\n";
+  file << "  \"buildFlags\": " << jsonString(AU2MHAS_BUILD_FLAGS) << ",\n";
+  file << "  \"repetitions\": " << repetitions << ",\n";
+  file << "  \"scenarios\": {\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto& result = results[i];
+    file << "    \"" << result.name << "\": {\"mbPerSec\": " << result.mbPerSec
+         << ", \"samplesPerSec\": " << result.samplesPerSec << ", \"spread\": " << result.spread;
+    if (asBaseline) {
+      file << ", \"tolerance\": " << toleranceFromSpread(result.spread);
+    } else {
+      file << ", \"peakRssMiB\": " << result.peakRssMiB << ", \"openMs\": " << result.openMs
+           << ", \"readMs\": " << result.readMs << ", \"convertMs\": " << result.convertMs
+           << ", \"writeMs\": " << result.writeMs;
+    }
+    file << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  file << "  }\n}\n";
+}
+
+//! Returns the number of metrics below the baseline (minus tolerance).
+static uint32_t compareWithBaseline(const std::string& path,
+                                    const std::vector<SScenarioResult>& results) {
+  const std::map<std::string, double> baseline = readJsonNumbers(path);
+  ILO_ASSERT(baseline.count("repetitions") != 0,
+             "%s contains no measured baseline, record one on the reference machine with -u",
+             path.c_str());
+  auto lookup = [&baseline](const std::string& key, double fallback) {
+    auto it = baseline.find(key);
+    return it == baseline.end() ? fallback : it->second;
+  };
+
+  uint32_t regressions = 0;
+  for (const auto& result : results) {
+    const std::string prefix = "scenarios." + result.name + ".";
+    const double scenarioTolerance =
+        lookup(prefix + "tolerance", toleranceFromSpread(lookup(prefix + "spread", 0.0)));
+    const std::map<std::string, double> measured = {{"mbPerSec", result.mbPerSec},
+                                                    {"samplesPerSec", result.samplesPerSec}};
+    for (const auto& metric : measured) {
+      auto it = baseline.find(prefix + metric.first);
+      if (it == baseline.end()) {
+        continue;
+      }
+      const double minimum = it->second * (1.0 - scenarioTolerance);
+      const bool regressed = metric.second < minimum;
+      std::printf("%-24s %-14s %12.2f (baseline %.2f, minimum %.2f) %s\n", result.name.c_str(),
+                  metric.first.c_str(), metric.second, it->second, minimum,
+                  regressed ? "REGRESSION" : "ok");
+      regressions += regressed ? 1 : 0;
+    }
+  }
+  return regressions;
+}
+
+int main(int argc, char* argv[]) {
+  std::string workDirectory;
+  std::string resultsFile;
+  std::string baselineFile;
+  std::string newBaselineFile;
+  uint64_t durationSec = 600;
+  uint64_t numDirectoryFiles = 16;
+  uint32_t repetitions = 3;
+
+  for (int i = 1; i < argc; i += 2) {
+    const std::string argument = argv[i];
+    if (argument == "-h" || argument == "--help") {
+      printUsage();
+      return EXIT_SUCCESS;
+    }
+    if (i + 1 >= argc) {
+      std::cout << "Missing value for command line parameter: " << argument << std::endl;
+      printUsage();
+      return EXIT_FAILURE;
+    }
+    const std::string value = argv[i + 1];
+    try {
+      if (argument == "-o") {
+        workDirectory = value;
+      } else if (argument == "-j") {
+        resultsFile = value;
+      } else if (argument == "-b") {
+        baselineFile = value;
+      } else if (argument == "-u") {
+        newBaselineFile = value;
+      } else if (argument == "-d") {
+        durationSec = std::stoull(value);
+      } else if (argument == "-n") {
+        numDirectoryFiles = std::stoull(value);
+      } else if (argument == "-r") {
+        repetitions = static_cast<uint32_t>(std::stoul(value));
+      } else {
+        std::cout << "Invalid command line parameter: " << argument << std::endl;
+        printUsage();
+        return EXIT_FAILURE;
+      }
+    } catch (const std::exception&) {
+      std::cout << "The parameter " << argument
+                << " needs to be a numerical value, got: " << value << std::endl;
+      printUsage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (workDirectory.empty() || repetitions == 0 || durationSec == 0 || numDirectoryFiles == 0 ||
+      (!newBaselineFile.empty() && repetitions < MIN_BASELINE_REPETITIONS)) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+
+  logging::disable();
+
+  std::vector<SScenarioResult> results;
+  uint32_t regressions = 0;
+  try {
+    const char separator = CDirectories::getPathSeparator();
+    const std::string inputDirectory = workDirectory + separator + "input";
+    const std::string directoryInput = workDirectory + separator + "directory_input";
+    const std::string outputDirectory = workDirectory + separator + "output";
+    ILO_ASSERT(CDirectories::createDirectory(workDirectory) !=
+                   CDirectories::ECreateDirectoryReturn::FAILED,
+               "Creating %s failed", workDirectory.c_str());
+    ILO_ASSERT(CDirectories::createDirectory(outputDirectory) !=
+                   CDirectories::ECreateDirectoryReturn::FAILED,
+               "Creating %s failed", outputDirectory.c_str());
+
+    std::cout << "Generating inputs in " << workDirectory << std::endl;
+    const SInput mhaInput =
+        generateInput(inputDirectory, "single_mha", EContainerFormat::MHA1, 1, durationSec);
+    const SInput mhmInput =
+        generateInput(inputDirectory, "single_mhm", EContainerFormat::MHM1, 1, durationSec);
+    const SInput batchInput = generateInput(directoryInput, "batch", EContainerFormat::MHA1,
+                                            numDirectoryFiles, DIRECTORY_FILE_DURATION_SEC);
+
+    const std::string outputFile = outputDirectory + separator + "single_out.mp4";
+    for (bool coldCache : {false, true}) {
+      results.push_back(
+          runFileScenario("file_mha1", mhaInput, outputFile, coldCache, repetitions));
+      results.push_back(
+          runFileScenario("file_mhm1", mhmInput, outputFile, coldCache, repetitions));
+      results.push_back(runDirectoryScenario("directory_mha1", batchInput, directoryInput,
+                                             outputDirectory, coldCache, repetitions));
+    }
+
+    printResults(results);
+    if (!resultsFile.empty()) {
+      writeResults(resultsFile, results, repetitions, false);
+    }
+    if (!newBaselineFile.empty()) {
+      writeResults(newBaselineFile, results, repetitions, true);
+    }
+    if (!baselineFile.empty()) {
+      regressions = compareWithBaseline(baselineFile, results);
+    }
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return 5;
+  }
+
+  if (regressions != 0) {
+    std::cout << regressions << " metric(s) regressed against the baseline" << std::endl;
+    return 1;
+  }
+  return EXIT_SUCCESS;
+}
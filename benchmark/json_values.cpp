@@ -0,0 +1,216 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// System includes
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+// Internal includes
+#include "json_values.h"
+
+namespace {
+class CJsonNumberReader {
+ public:
+  explicit CJsonNumberReader(const std::string& text) : m_text(text) {}
+
+  std::map<std::string, double> read() {
+    value("");
+    skipWhitespace();
+    if (m_position != m_text.size()) {
+      fail("Trailing characters");
+    }
+    return m_values;
+  }
+
+ private:
+  void fail(const char* message) const {
+    throw std::runtime_error(std::string(message) + " at offset " + std::to_string(m_position));
+  }
+
+  void skipWhitespace() {
+    while (m_position < m_text.size() &&
+           std::isspace(static_cast<unsigned char>(m_text[m_position]))) {
+      ++m_position;
+    }
+  }
+
+  char peek() {
+    skipWhitespace();
+    if (m_position >= m_text.size()) {
+      fail("Unexpected end of document");
+    }
+    return m_text[m_position];
+  }
+
+  void expect(char character) {
+    if (peek() != character) {
+      fail("Unexpected character");
+    }
+    ++m_position;
+  }
+
+  std::string string() {
+    expect('"');
+    std::string result;
+    while (m_position < m_text.size() && m_text[m_position] != '"') {
+      if (m_text[m_position] == '\\') {
+        ++m_position;
+      }
+      if (m_position < m_text.size()) {
+        result += m_text[m_position++];
+      }
+    }
+    expect('"');
+    return result;
+  }
+
+  void value(const std::string& path) {
+    char character = peek();
+    if (character == '{') {
+      ++m_position;
+      if (peek() == '}') {
+        ++m_position;
+        return;
+      }
+      for (;;) {
+        std::string key = string();
+        expect(':');
+        value(path.empty() ? key : path + "." + key);
+        if (peek() == ',') {
+          ++m_position;
+          continue;
+        }
+        expect('}');
+        return;
+      }
+    } else if (character == '[') {
+      ++m_position;
+      if (peek() == ']') {
+        ++m_position;
+        return;
+      }
+      for (;;) {
+        value(path + ".[]");
+        if (peek() == ',') {
+          ++m_position;
+          continue;
+        }
+        expect(']');
+        return;
+      }
+    } else if (character == '"') {
+      string();
+    } else if (character == '-' || std::isdigit(static_cast<unsigned char>(character))) {
+      const char* begin = m_text.c_str() + m_position;
+      char* end = nullptr;
+      double number = std::strtod(begin, &end);
+      m_position += static_cast<size_t>(end - begin);
+      if (path.find(".[]") == std::string::npos) {
+        m_values[path] = number;
+      }
+    } else {
+      // true, false or null
+      while (m_position < m_text.size() &&
+             std::isalpha(static_cast<unsigned char>(m_text[m_position]))) {
+        ++m_position;
+      }
+    }
+  }
+
+  const std::string& m_text;
+  size_t m_position = 0;
+  std::map<std::string, double> m_values;
+};
+}  // namespace
+
+std::map<std::string, double> mmt::au2mhasconverterlib::benchmark::readJsonNumbers(
+    const std::string& filePath) {
+  std::ifstream file(filePath);
+  if (!file) {
+    throw std::runtime_error("Opening " + filePath + " failed");
+  }
+  const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  return CJsonNumberReader(text).read();
+}
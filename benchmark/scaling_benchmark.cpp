@@ -0,0 +1,429 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// System includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// External includes
+#include "ilo/logging.h"
+
+// Internal includes
+#include "mmtau2mhasconverterlib/directory_converter.h"
+#include "mmtau2mhasconverterlib/log_redirect.h"
+#include "directories.h"
+#include "mp4_generator.h"
+
+using namespace mmt::au2mhasconverterlib;
+using namespace mmt::au2mhasconverterlib::generator;
+
+//! A corpus of generated files with a characteristic size distribution.
+struct SSizeMix {
+  std::string name;
+  uint64_t numFiles;
+  //! Every n-th file is long (0: no long files).
+  uint64_t longFileInterval;
+  uint64_t shortDurationSec;
+  uint64_t longDurationSec;
+};
+
+/*!
+ * A generated corpus split round-robin into shard directories.
+ *
+ * Every worker thread runs its own CDirectoryConverter on the next unprocessed shard, like
+ * several converter processes sharing a node.
+ */
+struct SCorpus {
+  std::vector<std::string> shards;
+  uint64_t bytes = 0;
+};
+
+struct SScalingResult {
+  std::string mix;
+  uint32_t threads = 0;
+  double wallSec = 0.0;
+  double mbPerSec = 0.0;
+  double speedup = 0.0;
+  double efficiency = 0.0;
+  double latencyP50Ms = 0.0;
+  double latencyP95Ms = 0.0;
+  double latencyP99Ms = 0.0;
+  double latencyMaxMs = 0.0;
+  uint64_t failed = 0;
+};
+
+static void printUsage() {
+  std::cout << "Usage: au2mhasscalingbenchmark [options] -o <work directory>" << std::endl;
+  std::cout << "Options:" << std::endl;
+  std::cout << "  -t <num>   (Optional) Maximal number of worker threads, default: hardware threads"
+            << std::endl;
+  std::cout << "  -m <name>  (Optional) Only run the size mix tiny, huge or mixed" << std::endl;
+  std::cout << "  -s <num>   (Optional) Scale the number of files of each mix in percent, "
+               "default 100"
+            << std::endl;
+  std::cout << "  -j <path>  (Optional) Write the results as JSON" << std::endl;
+}
+
+static void createDirectory(const std::string& path) {
+  ILO_ASSERT(CDirectories::createDirectory(path) != CDirectories::ECreateDirectoryReturn::FAILED,
+             "Creating %s failed", path.c_str());
+}
+
+static SCorpus generateCorpus(const std::string& workDirectory, const SSizeMix& mix,
+                              uint32_t numShards) {
+  const char separator = CDirectories::getPathSeparator();
+  const std::string directory = workDirectory + separator + mix.name;
+  createDirectory(directory);
+  SCorpus corpus;
+  for (uint32_t i = 0; i < numShards; ++i) {
+    corpus.shards.push_back(directory + separator + "shard_" + std::to_string(i));
+    createDirectory(corpus.shards.back());
+  }
+
+  for (uint64_t k = 0; k < mix.numFiles; ++k) {
+    const bool isLong = mix.longFileInterval != 0 && k % mix.longFileInterval == 0;
+    SStreamConfig streamConfig;
+    SMp4Config mp4Config;
+    streamConfig.seed = k + 1;
+    streamConfig.numFrames = (isLong ? mix.longDurationSec : mix.shortDurationSec) *
+                             mp4Config.sampleRate / mp4Config.frameLength;
+    char fileName[32];
+    std::snprintf(fileName, sizeof(fileName), "file_%06llu.mp4",
+                  static_cast<unsigned long long>(k));
+    mp4Config.outputFile = corpus.shards[k % numShards] + separator + fileName;
+    writeMp4File(streamConfig, mp4Config);
+    corpus.bytes += CDirectories::getFileSize(mp4Config.outputFile);
+  }
+  return corpus;
+}
+
+static std::vector<std::string> splitCsvLine(const std::string& line) {
+  std::vector<std::string> fields(1);
+  bool quoted = false;
+  for (size_t i = 0; i < line.size(); ++i) {
+    const char c = line[i];
+    if (quoted) {
+      if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+        fields.back() += '"';
+        ++i;
+      } else if (c == '"') {
+        quoted = false;
+      } else {
+        fields.back() += c;
+      }
+    } else if (c == '"') {
+      quoted = true;
+    } else if (c == ',') {
+      fields.emplace_back();
+    } else {
+      fields.back() += c;
+    }
+  }
+  return fields;
+}
+
+//! Adds the per-file job latencies (sum of all stages) of a CSV conversion report to @p latencies.
+static void readJobLatenciesMs(const std::string& reportFile, std::vector<double>& latencies,
+                               uint64_t& failed) {
+  std::ifstream file(reportFile);
+  ILO_ASSERT(file.good(), "Opening %s failed", reportFile.c_str());
+  std::string line;
+  std::getline(file, line);
+  const std::vector<std::string> header = splitCsvLine(line);
+  auto column = [&header](const std::string& name) {
+    auto it = std::find(header.begin(), header.end(), name);
+    ILO_ASSERT(it != header.end(), "Report column %s is missing", name.c_str());
+    return static_cast<size_t>(it - header.begin());
+  };
+  const size_t statusColumn = column("status");
+  const std::vector<size_t> stageColumns = {column("open_ns"), column("read_ns"),
+                                            column("convert_ns"), column("write_ns"),
+                                            column("publish_ns")};
+
+  while (std::getline(file, line)) {
+    const std::vector<std::string> fields = splitCsvLine(line);
+    if (fields.size() < header.size()) {
+      continue;
+    }
+    if (fields[statusColumn] != "succeeded") {
+      ++failed;
+      continue;
+    }
+    double totalNs = 0.0;
+    for (size_t stageColumn : stageColumns) {
+      totalNs += std::stod(fields[stageColumn]);
+    }
+    latencies.push_back(totalNs / 1e6);
+  }
+}
+
+static double percentile(const std::vector<double>& sorted, double fraction) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  const size_t index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static SScalingResult runConfiguration(const std::string& workDirectory, const SSizeMix& mix,
+                                       const SCorpus& corpus, uint32_t threads) {
+  const char separator = CDirectories::getPathSeparator();
+  std::vector<CDirectoryConverter::SConfig> configs(corpus.shards.size());
+  for (size_t i = 0; i < corpus.shards.size(); ++i) {
+    const std::string shard = "shard_" + std::to_string(i);
+    configs[i].inputDirectoryPath = corpus.shards[i];
+    configs[i].outputDirectoryPath = workDirectory + separator + "output_" + mix.name + separator +
+                                     shard;
+    configs[i].replaceFiles = true;
+    configs[i].reportFilePath =
+        workDirectory + separator + "report_" + mix.name + "_" + shard + ".csv";
+    configs[i].reportFormat = CDirectoryConverter::EReportFormat::CSV;
+  }
+
+  std::atomic<size_t> nextShard{0};
+  auto worker = [&]() {
+    for (size_t i = nextShard++; i < configs.size(); i = nextShard++) {
+      CDirectoryConverter(configs[i]).process();
+    }
+  };
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  for (uint32_t i = 1; i < threads; ++i) {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : workers) {
+    thread.join();
+  }
+  const double wallSec =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  SScalingResult result;
+  result.mix = mix.name;
+  result.threads = threads;
+  result.wallSec = wallSec;
+  result.mbPerSec = static_cast<double>(corpus.bytes) / 1e6 / wallSec;
+  std::vector<double> latencies;
+  for (const auto& config : configs) {
+    readJobLatenciesMs(config.reportFilePath, latencies, result.failed);
+  }
+  std::sort(latencies.begin(), latencies.end());
+  result.latencyP50Ms = percentile(latencies, 0.50);
+  result.latencyP95Ms = percentile(latencies, 0.95);
+  result.latencyP99Ms = percentile(latencies, 0.99);
+  result.latencyMaxMs = latencies.empty() ? 0.0 : latencies.back();
+  return result;
+}
+
+static void writeResults(const std::string& path, const std::vector<SScalingResult>& results) {
+  std::ofstream file(path);
+  ILO_ASSERT(file.good(), "Opening %s failed", path.c_str());
+  file << "[";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto& result = results[i];
+    file << (i == 0 ? "\n" : ",\n");
+    file << "  {\"mix\": \"" << result.mix << "\", \"threads\": " << result.threads
+         << ", \"wallSec\": " << result.wallSec << ", \"mbPerSec\": " << result.mbPerSec
+         << ", \"speedup\": " << result.speedup << ", \"efficiency\": " << result.efficiency
+         << ", \"latencyP50Ms\": " << result.latencyP50Ms
+         << ", \"latencyP95Ms\": " << result.latencyP95Ms
+         << ", \"latencyP99Ms\": " << result.latencyP99Ms
+         << ", \"latencyMaxMs\": " << result.latencyMaxMs << ", \"failed\": " << result.failed
+         << "}";
+  }
+  file << "\n]\n";
+}
+
+int main(int argc, char* argv[]) {
+  std::string workDirectory;
+  std::string resultsFile;
+  std::string mixFilter;
+  uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  uint64_t scalePercent = 100;
+
+  for (int i = 1; i < argc; i += 2) {
+    const std::string argument = argv[i];
+    if (argument == "-h" || argument == "--help") {
+      printUsage();
+      return EXIT_SUCCESS;
+    }
+    if (i + 1 >= argc) {
+      std::cout << "Missing value for command line parameter: " << argument << std::endl;
+      printUsage();
+      return EXIT_FAILURE;
+    }
+    const std::string value = argv[i + 1];
+    try {
+      if (argument == "-o") {
+        workDirectory = value;
+      } else if (argument == "-j") {
+        resultsFile = value;
+      } else if (argument == "-m") {
+        mixFilter = value;
+      } else if (argument == "-t") {
+        maxThreads = static_cast<uint32_t>(std::stoul(value));
+      } else if (argument == "-s") {
+        scalePercent = std::stoull(value);
+      } else {
+        std::cout << "Invalid command line parameter: " << argument << std::endl;
+        printUsage();
+        return EXIT_FAILURE;
+      }
+    } catch (const std::exception&) {
+      std::cout << "The parameter " << argument
+                << " needs to be a numerical value, got: " << value << std::endl;
+      printUsage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (workDirectory.empty() || maxThreads == 0 || scalePercent == 0) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+
+  // the library logging would be a contention point of its own
+  logging::disable();
+
+  // many tiny files stress the per-file overhead, few huge files the load balancing
+  const std::vector<SSizeMix> mixes = {
+      {"tiny", 256, 0, 2, 0}, {"huge", 4, 1, 0, 600}, {"mixed", 48, 5, 10, 180}};
+
+  std::vector<uint32_t> threadCounts;
+  for (uint32_t threads = 1; threads < maxThreads; threads *= 2) {
+    threadCounts.push_back(threads);
+  }
+  threadCounts.push_back(maxThreads);
+
+  std::vector<SScalingResult> results;
+  try {
+    createDirectory(workDirectory);
+    for (SSizeMix mix : mixes) {
+      if (!mixFilter.empty() && mix.name != mixFilter) {
+        continue;
+      }
+      mix.numFiles = std::max<uint64_t>(1, mix.numFiles * scalePercent / 100);
+      std::cout << "Generating " << mix.numFiles << " files for mix " << mix.name << std::endl;
+      const SCorpus corpus = generateCorpus(workDirectory, mix, maxThreads);
+
+      // warm up the page cache, the speedups compare warm runs only
+      runConfiguration(workDirectory, mix, corpus, maxThreads);
+      double singleThreadSec = 0.0;
+      for (uint32_t threads : threadCounts) {
+        SScalingResult result = runConfiguration(workDirectory, mix, corpus, threads);
+        if (threads == 1) {
+          singleThreadSec = result.wallSec;
+        }
+        result.speedup = singleThreadSec / result.wallSec;
+        result.efficiency = result.speedup / threads;
+        results.push_back(result);
+      }
+    }
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return 5;
+  }
+
+  std::printf("%-8s %8s %10s %10s %8s %8s %12s %12s %12s %12s %7s\n", "mix", "threads", "wall s",
+              "MB/s", "speedup", "effic.", "p50 ms", "p95 ms", "p99 ms", "max ms", "failed");
+  for (const auto& result : results) {
+    std::printf("%-8s %8u %10.2f %10.2f %8.2f %8.2f %12.1f %12.1f %12.1f %12.1f %7llu\n",
+                result.mix.c_str(), result.threads, result.wallSec, result.mbPerSec,
+                result.speedup, result.efficiency, result.latencyP50Ms, result.latencyP95Ms,
+                result.latencyP99Ms, result.latencyMaxMs,
+                static_cast<unsigned long long>(result.failed));
+  }
+  if (!resultsFile.empty()) {
+    writeResults(resultsFile, results);
+  }
+  return EXIT_SUCCESS;
+}
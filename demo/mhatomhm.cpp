@@ -91,6 +91,7 @@ amm-info@iis.fraunhofer.de
 
 // Internal includes
 #include "mmtau2mhasconverterlib/file_converter.h"
+#include "mmtau2mhasconverterlib/file_probe.h"
 #include "logging.h"
 
 using namespace mmt;
@@ -108,6 +109,87 @@ static void printUsage() {
   std::cout << "  -p <num>           (Optional) Value (1 to 16) to overwrite the initial packet "
                "label with"
             << std::endl;
+  std::cout << "  -c convert|copy|skip (Optional) Handling of already compliant mhm1 input, "
+               "\"convert\" (default), \"copy\" the input file or \"skip\" writing the output"
+            << std::endl;
+  std::cout << std::endl;
+  std::cout << "Usage: mhatomhm -probe <path to mha1 or mhm1 MP4 file>" << std::endl;
+  std::cout << "  Only checks whether the file can be converted, no output is written" << std::endl;
+}
+
+static std::string profileLevelText(const SProfileLevel& profileLevel) {
+  if (!profileLevel.isSet()) {
+    return "-";
+  }
+  char text[8];
+  std::snprintf(text, sizeof(text), "0x%02X", static_cast<unsigned>(profileLevel.get()));
+  return text;
+}
+
+static void printConfigValidation(const std::string& name, const SConfigValidation& validation) {
+  std::cout << name << ": profile level " << profileLevelText(validation.profileLevel)
+            << ", compatible profile level " << profileLevelText(validation.compatibleProfileLevel)
+            << ", ASI " << (validation.hasAsi ? "yes" : "no") << std::endl;
+
+  if (validation.status != EConversionStatus::OK) {
+    SConversionDiagnostics diagnostics;
+    diagnostics.status = validation.status;
+    diagnostics.violations = validation.violations;
+    diagnostics.profileLevel = validation.profileLevel.isSet() ? validation.profileLevel.get() : 0;
+    diagnostics.parserError = validation.parserError;
+    std::cout << "  " << diagnostics.message() << std::endl;
+  }
+}
+
+static int probeFile(const std::string& inputFile) {
+  LOG_DISABLE_LOGGING();
+
+  SFileProbeReport report;
+  try {
+    CFileProbe::SConfig probeConfig;
+    probeConfig.inputFile = inputFile;
+    report = CFileProbe(probeConfig).probe();
+  } catch (std::runtime_error& error) {
+    std::cerr << error.what() << std::endl;
+    return 5;
+  } catch (...) {
+    std::cerr << "Error while processing" << std::endl;
+    return 6;
+  }
+
+  std::cout << inputFile << " (" << (report.isMhm ? "mhm1" : "mha1") << ")" << std::endl;
+  if (report.hasFileConfig) {
+    printConfigValidation("Sample entry config", report.fileConfig);
+  } else {
+    std::cout << "Sample entry config: none" << std::endl;
+  }
+  for (size_t i = 0; i < report.inBandConfigs.size(); ++i) {
+    printConfigValidation("In-band config " + std::to_string(i + 1), report.inBandConfigs[i]);
+  }
+
+  std::cout << "Samples: " << report.samples << ", IPFs: " << report.ipfs;
+  if (report.ipfs != 0) {
+    std::cout << " (first at sample " << report.firstIpf << ")";
+  }
+  if (report.ipfs > 1) {
+    std::cout << ", IPF distance: " << report.minIpfDistance << " to " << report.maxIpfDistance
+              << " samples";
+  }
+  std::cout << ", config changes: " << report.configChanges;
+  if (report.truncatedIpfs != 0) {
+    std::cout << ", truncated IPFs: " << report.truncatedIpfs << " (first at sample "
+              << report.firstTruncatedIpf << ")";
+  }
+  if (!report.complete) {
+    std::cout << " (first " << report.samples << " samples only)";
+  }
+  std::cout << std::endl;
+
+  const bool convertible = report.isConvertible();
+  std::cout << (convertible ? "Baseline compatible after conversion"
+                            : "Not convertible to a Baseline compatible file")
+            << std::endl;
+  return convertible ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 int main(int argc, char* argv[]) {
@@ -115,8 +197,13 @@ int main(int argc, char* argv[]) {
   std::string outputFile;
   std::string logFile;
   std::string editList;
+  std::string compliantHandling;
   uint32_t packetLabel = 1;
 
+  if (argc == 3 && std::string{"-probe"} == argv[1]) {
+    return probeFile(argv[2]);
+  }
+
   if (argc < 4 /* program, input file, output flag, output file */) {
     printUsage();
     return EXIT_FAILURE;
@@ -129,6 +216,8 @@ int main(int argc, char* argv[]) {
       logFile = argv[i + 1];
     } else if (std::string{"-e"} == argv[i]) {
       editList = argv[i + 1];
+    } else if (std::string{"-c"} == argv[i]) {
+      compliantHandling = argv[i + 1];
     } else if (std::string{"-p"} == argv[i]) {
       try {
         packetLabel = std::stoul(argv[i + 1]);
@@ -177,6 +266,14 @@ int main(int argc, char* argv[]) {
     printUsage();
     return EXIT_FAILURE;
   }
+  if (!compliantHandling.empty() && compliantHandling != "convert" && compliantHandling != "copy" &&
+      compliantHandling != "skip") {
+    std::cout << "Invalid compliant input handling provided, allowed are 'convert', 'copy' and "
+                 "'skip'."
+              << std::endl;
+    printUsage();
+    return EXIT_FAILURE;
+  }
 
   if (logFile.empty()) {
     LOG_DISABLE_LOGGING();  // disable to not clutter system logs or console
@@ -215,6 +312,12 @@ int main(int argc, char* argv[]) {
       converterConfig.resetEditlistMediaTime = true;
     }
 
+    if (compliantHandling == "copy") {
+      converterConfig.compliantMhmHandling = ECompliantInputHandling::COPY;
+    } else if (compliantHandling == "skip") {
+      converterConfig.compliantMhmHandling = ECompliantInputHandling::SKIP;
+    }
+
     CFileConverter runner(converterConfig);
 
     std::cout << "Converting " << inputFile << " to " << outputFile << std::endl;
@@ -229,6 +332,10 @@ int main(int argc, char* argv[]) {
     std::cout << std::endl;
     std::cout << "0%..." << std::endl;
     runner.process();
+    if (runner.statistics().compliantInput) {
+      std::cout << "Input is already compliant, "
+                << (compliantHandling == "copy" ? "copied it" : "no output written") << std::endl;
+    }
   } catch (std::runtime_error& error) {
     std::cerr << error.what() << std::endl;
     return 5;
@@ -0,0 +1,293 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// External includes
+#include "ilo/bitbuffer.h"
+#include "mmtmhasparserlib/mhasconfigpacket.h"
+#include "mmtmhasparserlib/mhasframepacket.h"
+#include "mmtmhasparserlib/mhassyncpacket.h"
+#include "mmtmhasparserlib/mhasutilities.h"
+
+// Internal includes
+#include "bitstream_builder.h"
+
+using namespace mmt::au2mhasconverterlib;
+using namespace mmt::au2mhasconverterlib::generator;
+
+static constexpr uint32_t ID_EXT_ELE_AUDIOPREROLL = 3;
+static constexpr uint32_t ID_EXT_ELE_UNI_DRC = 4;
+static constexpr uint32_t ID_CONFIG_EXT_FILL = 0;
+static constexpr uint32_t ID_CONFIG_EXT_AUDIOSCENE_INFO = 3;
+static constexpr uint8_t CONFIG_EXT_FILL_BYTE = 0xA5;
+
+enum class ElementType : uint8_t { SCE = 0, CPE = 1, LFE = 2, EXT = 3 };
+
+static uint8_t patternByte(size_t index) {
+  return static_cast<uint8_t>(index * 31u + 7u);
+}
+
+static void writeBytes(ilo::CBitBuffer& writer, size_t size, size_t offset = 0) {
+  for (size_t i = 0; i < size; ++i) {
+    writer.write(patternByte(i + offset), 8);
+  }
+}
+
+static void writeCoreConfig(ilo::CBitBuffer& writer) {
+  writer.write(0u, 1);  // tw_mdct
+  writer.write(0u, 1);  // fullbandLpd
+  writer.write(1u, 1);  // noiseFilling
+  writer.write(0u, 1);  // enhancedNoiseFilling
+}
+
+static void writeElement(ilo::CBitBuffer& writer, ElementType type) {
+  writer.write(static_cast<uint8_t>(type), 2);
+  switch (type) {
+    case ElementType::SCE:
+      writeCoreConfig(writer);
+      break;
+    case ElementType::CPE:
+      writeCoreConfig(writer);
+      writer.write(0u, 2);  // qceIndex
+      writer.write(0u, 1);  // shiftIndex1
+      writer.write(0u, 1);  // lpdStereoIndex
+      break;
+    default:
+      break;
+  }
+}
+
+static void writeExtElement(ilo::CBitBuffer& writer, uint32_t type, uint32_t configSize) {
+  writer.write(static_cast<uint8_t>(ElementType::EXT), 2);
+  mmt::mhasparserlib::writeEscapedValue(writer, type, 4, 8, 16);
+  mmt::mhasparserlib::writeEscapedValue(writer, configSize, 4, 8, 16);
+  writer.write(0u, 1);  // usacExtElementDefaultLengthPresent
+  writer.write(0u, 1);  // usacExtElementPayloadFrag
+  writeBytes(writer, configSize);
+}
+
+ByteBuffer mmt::au2mhasconverterlib::generator::buildConfig(const SConfigShape& shape) {
+  ilo::CBitBuffer writer;
+  writer.write(shape.profileLevel, 8);
+  writer.write(3u, 5);  // usacSamplingFrequencyIndex: 48 kHz
+  writer.write(1u, 3);  // coreSbrFrameLengthIndex: 1024 samples
+  writer.write(0u, 1);  // cfg_reserved
+  writer.write(0u, 1);  // receiverDelayCompensation
+
+  // SpeakerConfig3d: CICP 5.1
+  writer.write(0u, 2);
+  writer.write(6u, 6);
+
+  // FrameworkConfig3d
+  const uint32_t numSignalGroups = shape.numChannelGroups + shape.numObjectGroups;
+  writer.write(numSignalGroups - 1, 5);
+  for (uint32_t i = 0; i < shape.numChannelGroups; ++i) {
+    writer.write(0u, 3);  // SignalGroupTypeChannels
+    mmt::mhasparserlib::writeEscapedValue(writer, 6 - 1, 5, 8, 16);
+    writer.write(0u, 1);  // differsFromReferenceLayout
+  }
+  for (uint32_t i = 0; i < shape.numObjectGroups; ++i) {
+    writer.write(1u, 3);  // SignalGroupTypeObject
+    mmt::mhasparserlib::writeEscapedValue(writer, shape.objectsPerGroup - 1, 5, 8, 16);
+  }
+
+  // mpegh3daDecoderConfig
+  const uint32_t numElements = shape.numExtElements + shape.numChannelGroups * 4 +
+                               shape.numObjectGroups * shape.objectsPerGroup;
+  mmt::mhasparserlib::writeEscapedValue(writer, numElements - 1, 4, 8, 16);
+  writer.write(1u, 1);  // elementLengthPresent
+  for (uint32_t i = 0; i < shape.numExtElements; ++i) {
+    if (i == 0) {
+      writeExtElement(writer, ID_EXT_ELE_AUDIOPREROLL, 0);
+    } else {
+      writeExtElement(writer, ID_EXT_ELE_UNI_DRC, shape.extElementConfigSize);
+    }
+  }
+  for (uint32_t i = 0; i < shape.numChannelGroups; ++i) {
+    writeElement(writer, ElementType::SCE);
+    writeElement(writer, ElementType::CPE);
+    writeElement(writer, ElementType::CPE);
+    writeElement(writer, ElementType::LFE);
+  }
+  for (uint32_t i = 0; i < shape.numObjectGroups * shape.objectsPerGroup; ++i) {
+    writeElement(writer, ElementType::SCE);
+  }
+
+  // mpegh3daConfigExtension
+  const uint32_t numConfigExtensions = shape.numFillConfigExtensions + (shape.asiSize ? 1 : 0);
+  if (numConfigExtensions != 0) {
+    writer.write(1u, 1);
+    mmt::mhasparserlib::writeEscapedValue(writer, numConfigExtensions - 1, 2, 4, 8);
+    if (shape.asiSize != 0) {
+      mmt::mhasparserlib::writeEscapedValue(writer, ID_CONFIG_EXT_AUDIOSCENE_INFO, 4, 8, 16);
+      mmt::mhasparserlib::writeEscapedValue(writer, shape.asiSize, 4, 8, 16);
+      writeBytes(writer, shape.asiSize);
+    }
+    for (uint32_t i = 0; i < shape.numFillConfigExtensions; ++i) {
+      mmt::mhasparserlib::writeEscapedValue(writer, ID_CONFIG_EXT_FILL, 4, 8, 16);
+      mmt::mhasparserlib::writeEscapedValue(writer, shape.fillConfigExtensionSize, 4, 8, 16);
+      for (uint32_t k = 0; k < shape.fillConfigExtensionSize; ++k) {
+        writer.write(CONFIG_EXT_FILL_BYTE, 8);
+      }
+    }
+  } else {
+    writer.write(0u, 1);
+  }
+
+  writer.byteAlign();
+  return writer.bytebuffer();
+}
+
+ByteBuffer mmt::au2mhasconverterlib::generator::buildFrame(size_t size, bool independent) {
+  ByteBuffer frame(size);
+  for (size_t i = 0; i < size; ++i) {
+    frame[i] = patternByte(i);
+  }
+  if (!frame.empty()) {
+    // usacIndependencyFlag, no AudioPreRoll payload present
+    frame[0] = independent ? 0x80u : 0x00u;
+  }
+  return frame;
+}
+
+ByteBuffer mmt::au2mhasconverterlib::generator::buildIpf(const ByteBuffer& config,
+                                                        size_t preRollSize, size_t frameSize) {
+  // AudioPreRoll()
+  ilo::CBitBuffer preRoll;
+  mmt::mhasparserlib::writeEscapedValue(preRoll, config.size(), 4, 4, 8);
+  for (uint8_t byte : config) {
+    preRoll.write(byte, 8);
+  }
+  preRoll.write(1u, 1);  // applyCrossfade
+  preRoll.write(0u, 1);  // reserved
+  mmt::mhasparserlib::writeEscapedValue(preRoll, 1, 2, 4, 0);  // numPreRollFrames
+  mmt::mhasparserlib::writeEscapedValue(preRoll, preRollSize, 16, 16, 0);
+  for (size_t i = 0; i < preRollSize; ++i) {
+    // the pre-roll AU is an independent frame
+    preRoll.write(i == 0 ? 0x80u : static_cast<uint32_t>(patternByte(i)), 8);
+  }
+  preRoll.byteAlign();
+  const ByteBuffer preRollBuffer = preRoll.bytebuffer();
+
+  ilo::CBitBuffer writer;
+  writer.write(1u, 1);  // usacIndependencyFlag
+  writer.write(1u, 1);  // usacExtElementPresent
+  writer.write(0u, 1);  // usacExtElementUseDefaultLength
+  const uint32_t payloadLength = static_cast<uint32_t>(preRollBuffer.size());
+  if (payloadLength > 254) {
+    writer.write(255u, 8);
+    writer.write(payloadLength - 253, 16);
+  } else {
+    writer.write(payloadLength, 8);
+  }
+  for (uint8_t byte : preRollBuffer) {
+    writer.write(byte, 8);
+  }
+  writeBytes(writer, frameSize, preRollSize);
+  writer.byteAlign();
+  return writer.bytebuffer();
+}
+
+ByteBuffer mmt::au2mhasconverterlib::generator::buildMhmSample(const ByteBuffer& config,
+                                                              const ByteBuffer& frame, bool isIpf,
+                                                              uint32_t packetLabel) {
+  ByteBuffer sample;
+  ByteBuffer packetBuffer;
+
+  mmt::mhasparserlib::CMhasSyncPacket syncPacket;
+  packetBuffer.resize(syncPacket.calculatePacketSize());
+  syncPacket.writePacket(packetBuffer);
+  sample.insert(sample.end(), packetBuffer.begin(), packetBuffer.end());
+
+  if (!config.empty()) {
+    mmt::mhasparserlib::CMhasConfigPacket configPacket(packetLabel, config.begin(), config.end());
+    packetBuffer.resize(configPacket.calculatePacketSize());
+    configPacket.writePacket(packetBuffer);
+    sample.insert(sample.end(), packetBuffer.begin(), packetBuffer.end());
+  }
+
+  auto begin = frame.cbegin();
+  mmt::mhasparserlib::CMhasFramePacket framePacket(packetLabel, begin, frame.cend(), isIpf);
+  packetBuffer.resize(framePacket.calculatePacketSize());
+  framePacket.writePacket(packetBuffer);
+  sample.insert(sample.end(), packetBuffer.begin(), packetBuffer.end());
+  return sample;
+}
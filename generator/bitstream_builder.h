@@ -0,0 +1,150 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/**
+ * @file bitstream_builder.h
+ *
+ * @brief Builds synthetic MPEG-H 3DA configs, frames and MHAS samples.
+ */
+#pragma once
+
+// System includes
+#include <cstdint>
+
+// Internal includes
+#include "mmtau2mhasconverterlib/converter.h"
+
+namespace mmt {
+namespace au2mhasconverterlib {
+namespace generator {
+//! Shape of a synthetic MPEG-H 3DA Low Complexity config.
+struct SConfigShape {
+  //! The mpegh3daProfileLevelIndication (LC level 3 by default).
+  uint8_t profileLevel = 0x0D;
+  //! Number of 5.1 channel signal groups (each adds SCE, 2 CPE and LFE elements).
+  uint32_t numChannelGroups = 1;
+  //! Number of object signal groups.
+  uint32_t numObjectGroups = 0;
+  //! Number of objects per object signal group (each adds one SCE element).
+  uint32_t objectsPerGroup = 4;
+  //! Number of extension elements, the first one is the AudioPreRoll element.
+  uint32_t numExtElements = 1;
+  //! Size of the config of each additional extension element in bytes.
+  uint32_t extElementConfigSize = 8;
+  //! Size of the audio scene information config extension in bytes (0: no ASI).
+  uint32_t asiSize = 0;
+  //! Number of fill config extensions.
+  uint32_t numFillConfigExtensions = 0;
+  //! Size of each fill config extension in bytes.
+  uint32_t fillConfigExtensionSize = 16;
+};
+
+/*!
+ * @brief Builds a raw mpegh3daConfig() with the given shape.
+ *
+ * The config is syntactically valid for the converter. The ASI payload is filler data, it is not
+ * a valid mae_AudioSceneInfo().
+ */
+ByteBuffer buildConfig(const SConfigShape& shape);
+
+//! Builds a raw mpegh3daFrame() of @p size bytes (no IPF).
+ByteBuffer buildFrame(size_t size, bool independent);
+
+/*!
+ * @brief Builds a raw Immediate Playout Frame (IPF).
+ *
+ * The AudioPreRoll extension element carries @p config (may be empty) and one pre-roll access
+ * unit of @p preRollSize bytes, it is followed by @p frameSize bytes of frame payload.
+ */
+ByteBuffer buildIpf(const ByteBuffer& config, size_t preRollSize, size_t frameSize);
+
+/*!
+ * @brief Builds the payload of a MHM1 sample.
+ *
+ * The sample consists of a sync packet, a config packet (only if @p config is not empty) and a
+ * frame packet carrying @p frame.
+ */
+ByteBuffer buildMhmSample(const ByteBuffer& config, const ByteBuffer& frame, bool isIpf,
+                          uint32_t packetLabel);
+}  // namespace generator
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
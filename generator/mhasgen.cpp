@@ -0,0 +1,242 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// System includes
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <string>
+
+// Internal includes
+#include "directories.h"
+#include "mp4_generator.h"
+
+using namespace mmt::au2mhasconverterlib;
+using namespace mmt::au2mhasconverterlib::generator;
+
+static void printUsage() {
+  std::cout << "Usage: mhasgen [options] -o <output MP4 file or directory>" << std::endl;
+
+  std::cout << "Options:" << std::endl;
+  std::cout << "  -f mha1|mhm1 (Optional) Sample entry type, default \"mha1\"" << std::endl;
+  std::cout << "  -n <num>     (Optional) Generate a corpus of <num> files into the output "
+               "directory, file k uses seed + k"
+            << std::endl;
+  std::cout << "  -d <sec>     (Optional) Duration of each file in seconds, default 30"
+            << std::endl;
+  std::cout << "  -i <num>     (Optional) IPF interval in frames, default 50 (0: first frame only)"
+            << std::endl;
+  std::cout << "  -e 0|1       (Optional) Embed the config in the IPFs (mha1 only), default 1"
+            << std::endl;
+  std::cout << "  -b <bytes>   (Optional) Mean access unit size, default 512" << std::endl;
+  std::cout << "  -j <bytes>   (Optional) Access unit size jitter, default 128" << std::endl;
+  std::cout << "  -c <num>     (Optional) Number of 5.1 channel signal groups, default 1"
+            << std::endl;
+  std::cout << "  -g <num>     (Optional) Number of object signal groups, default 0" << std::endl;
+  std::cout << "  -k <num>     (Optional) Number of objects per object group, default 4"
+            << std::endl;
+  std::cout << "  -x <num>     (Optional) Number of extension elements, default 1" << std::endl;
+  std::cout << "  -a <bytes>   (Optional) Size of the ASI config extension, default 0 (no ASI)"
+            << std::endl;
+  std::cout << "  -s <seed>    (Optional) Random seed, default 1" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  SStreamConfig streamConfig;
+  SMp4Config mp4Config;
+  std::string output;
+  std::string format = "mha1";
+  uint64_t numFiles = 0;
+  uint64_t durationSec = 30;
+
+  if (argc < 3 /* program, output flag, output */) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+
+  for (int i = 1; i < argc; i += 2) {
+    const std::string argument = argv[i];
+    if (argument == "-h" || argument == "--help") {
+      printUsage();
+      return EXIT_SUCCESS;
+    }
+    if (i + 1 >= argc) {
+      std::cout << "Missing value for command line parameter: " << argument << std::endl;
+      printUsage();
+      return EXIT_FAILURE;
+    }
+    const std::string value = argv[i + 1];
+    if (argument == "-o") {
+      output = value;
+      continue;
+    }
+    if (argument == "-f") {
+      format = value;
+      continue;
+    }
+
+    uint64_t number = 0;
+    try {
+      number = std::stoull(value);
+    } catch (const std::exception&) {
+      std::cout << "The parameter " << argument
+                << " needs to be a numerical value, got: " << value << std::endl;
+      printUsage();
+      return EXIT_FAILURE;
+    }
+
+    if (argument == "-n") {
+      numFiles = number;
+    } else if (argument == "-d") {
+      durationSec = number;
+    } else if (argument == "-i") {
+      streamConfig.ipfInterval = static_cast<uint32_t>(number);
+    } else if (argument == "-e") {
+      streamConfig.embedConfigInIpf = number != 0;
+    } else if (argument == "-b") {
+      streamConfig.meanFrameSize = static_cast<uint32_t>(number);
+    } else if (argument == "-j") {
+      streamConfig.frameSizeJitter = static_cast<uint32_t>(number);
+    } else if (argument == "-c") {
+      streamConfig.configShape.numChannelGroups = static_cast<uint32_t>(number);
+    } else if (argument == "-g") {
+      streamConfig.configShape.numObjectGroups = static_cast<uint32_t>(number);
+    } else if (argument == "-k") {
+      streamConfig.configShape.objectsPerGroup = static_cast<uint32_t>(number);
+    } else if (argument == "-x") {
+      streamConfig.configShape.numExtElements = static_cast<uint32_t>(number);
+    } else if (argument == "-a") {
+      streamConfig.configShape.asiSize = static_cast<uint32_t>(number);
+    } else if (argument == "-s") {
+      streamConfig.seed = number;
+    } else {
+      std::cout << "Invalid command line parameter: " << argument << std::endl;
+      printUsage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (output.empty()) {
+    std::cout << "The output needs to be set" << std::endl;
+    printUsage();
+    return EXIT_FAILURE;
+  }
+  if (format == "mha1") {
+    mp4Config.format = EContainerFormat::MHA1;
+  } else if (format == "mhm1") {
+    mp4Config.format = EContainerFormat::MHM1;
+  } else {
+    std::cout << "Invalid format provided, allowed formats are 'mha1' and 'mhm1'." << std::endl;
+    printUsage();
+    return EXIT_FAILURE;
+  }
+  streamConfig.numFrames = durationSec * mp4Config.sampleRate / mp4Config.frameLength;
+
+  try {
+    if (numFiles == 0) {
+      mp4Config.outputFile = output;
+      SMp4Statistics statistics = writeMp4File(streamConfig, mp4Config);
+      std::cout << "Wrote " << statistics.samples << " samples (" << statistics.ipfs << " IPFs, "
+                << statistics.sampleBytes << " bytes) to " << output << std::endl;
+      return EXIT_SUCCESS;
+    }
+
+    if (CDirectories::createDirectory(output) == CDirectories::ECreateDirectoryReturn::FAILED) {
+      std::cerr << "Creating the output directory failed: " << output << std::endl;
+      return EXIT_FAILURE;
+    }
+    const uint64_t baseSeed = streamConfig.seed;
+    for (uint64_t k = 0; k < numFiles; ++k) {
+      char fileName[32];
+      std::snprintf(fileName, sizeof(fileName), "gen_%06llu.mp4",
+                    static_cast<unsigned long long>(k));
+      streamConfig.seed = baseSeed + k;
+      mp4Config.outputFile = output + CDirectories::getPathSeparator() + fileName;
+      writeMp4File(streamConfig, mp4Config);
+    }
+    std::cout << "Wrote " << numFiles << " files to " << output << std::endl;
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return 5;
+  }
+  return EXIT_SUCCESS;
+}
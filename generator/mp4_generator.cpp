@@ -0,0 +1,172 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// System includes
+#include <utility>
+
+// External includes
+#include "ilo/bytebuffertools.h"
+#include "ilo/memory.h"
+#include "mmtisobmff/helper/commonhelpertools.h"
+#include "mmtisobmff/writer/output.h"
+#include "mmtisobmff/writer/trackwriter.h"
+
+// Internal includes
+#include "mp4_generator.h"
+
+using namespace mmt::au2mhasconverterlib;
+using namespace mmt::au2mhasconverterlib::generator;
+
+static constexpr uint8_t CICP_LAYOUT_5_1 = 6;
+
+SMp4Statistics mmt::au2mhasconverterlib::generator::writeMp4File(const SStreamConfig& streamConfig,
+                                                                 const SMp4Config& mp4Config) {
+  const bool isMhm = mp4Config.format == EContainerFormat::MHM1;
+  SStreamConfig effectiveStreamConfig = streamConfig;
+  if (isMhm) {
+    effectiveStreamConfig.embedConfigInIpf = false;
+  }
+  CAccessUnitGenerator generator(effectiveStreamConfig);
+
+  mmt::isobmff::CIsobmffFileWriter::SOutputConfig outputConfig;
+  outputConfig.outputUri = mp4Config.outputFile;
+
+  mmt::isobmff::SMovieConfig movieConfig;
+  movieConfig.currentTimeInUtc = mmt::isobmff::tools::currentUTCTime();
+  movieConfig.majorBrand = ilo::toFcc("mp42");
+  movieConfig.movieTimeScale = mp4Config.sampleRate;
+  movieConfig.compatibleBrands = {ilo::toFcc("mp42"), ilo::toFcc("isom")};
+
+  std::unique_ptr<mmt::isobmff::CIsobmffWriter> writer =
+      ilo::make_unique<mmt::isobmff::CIsobmffFileWriter>(outputConfig, movieConfig);
+  std::unique_ptr<mmt::isobmff::CMpeghTrackWriter> trackWriter;
+  if (isMhm) {
+    mmt::isobmff::SMpeghMhm1TrackConfig trackConfig;
+    trackConfig.language = "und";
+    trackConfig.mediaTimescale = mp4Config.sampleRate;
+    trackConfig.sampleRate = mp4Config.sampleRate;
+    trackConfig.profileAndLevelCompatibleSets = mp4Config.profileAndLevelCompatibleSets;
+    trackWriter = writer->trackWriter<mmt::isobmff::CMpeghTrackWriter>(trackConfig);
+  } else {
+    auto configRecord = ilo::make_unique<mmt::isobmff::config::CMhaDecoderConfigRecord>();
+    configRecord->setConfigurationVersion(1);
+    configRecord->setMpegh3daProfileLevelIndication(streamConfig.configShape.profileLevel);
+    configRecord->setReferenceChannelLayout(CICP_LAYOUT_5_1);
+    configRecord->setMpegh3daConfig(generator.config());
+
+    mmt::isobmff::SMpeghMha1TrackConfig trackConfig;
+    trackConfig.language = "und";
+    trackConfig.mediaTimescale = mp4Config.sampleRate;
+    trackConfig.sampleRate = mp4Config.sampleRate;
+    trackConfig.configRecord = std::move(configRecord);
+    trackConfig.profileAndLevelCompatibleSets = mp4Config.profileAndLevelCompatibleSets;
+    trackWriter = writer->trackWriter<mmt::isobmff::CMpeghTrackWriter>(trackConfig);
+  }
+
+  SMp4Statistics statistics;
+  SAccessUnit accessUnit;
+  mmt::isobmff::CSample sample;
+  sample.duration = mp4Config.frameLength;
+  while (generator.next(accessUnit)) {
+    sample.isSyncSample = accessUnit.isIpf;
+    if (isMhm) {
+      sample.rawData = buildMhmSample(accessUnit.isIpf ? generator.config() : ByteBuffer{},
+                                      accessUnit.data, accessUnit.isIpf, mp4Config.packetLabel);
+    } else {
+      // swap instead of copy, the buffers are swapped back to be reused by the generator
+      sample.rawData.swap(accessUnit.data);
+    }
+    trackWriter->addSample(sample);
+
+    ++statistics.samples;
+    statistics.ipfs += accessUnit.isIpf ? 1 : 0;
+    statistics.sampleBytes += sample.rawData.size();
+    if (!isMhm) {
+      sample.rawData.swap(accessUnit.data);
+    }
+  }
+
+  // finalizes the file
+  trackWriter.reset();
+  writer.reset();
+  return statistics;
+}
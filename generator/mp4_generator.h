@@ -0,0 +1,144 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/**
+ * @file mp4_generator.h
+ *
+ * @brief Writes synthetic MPEG-H 3DA streams into mha1 or mhm1 MP4 files.
+ */
+#pragma once
+
+// System includes
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Internal includes
+#include "stream_generator.h"
+
+namespace mmt {
+namespace au2mhasconverterlib {
+namespace generator {
+//! MP4 sample entry type of the generated file.
+enum class EContainerFormat {
+  //! Raw access units, the config is stored in the MHA decoder config record.
+  MHA1,
+  //! MHAS packets, the config is transported in-band in front of every IPF.
+  MHM1
+};
+
+//! Configuration of the generated MP4 file.
+struct SMp4Config {
+  //! The file to write.
+  std::string outputFile;
+  //! The sample entry type.
+  EContainerFormat format = EContainerFormat::MHA1;
+  //! Sample rate (and media timescale) of the track.
+  uint32_t sampleRate = 48000;
+  //! Number of audio samples per access unit.
+  uint32_t frameLength = 1024;
+  //! The packet label of the MHAS packets (MHM1 only).
+  uint32_t packetLabel = 1;
+  //! The compatible sets of the 'mhaP' box of the sample entry, empty writes no 'mhaP' box.
+  std::vector<uint8_t> profileAndLevelCompatibleSets;
+};
+
+//! Counters of a generated MP4 file.
+struct SMp4Statistics {
+  //! Number of written samples.
+  uint64_t samples = 0;
+  //! Number of written IPFs.
+  uint64_t ipfs = 0;
+  //! Number of written sample bytes.
+  uint64_t sampleBytes = 0;
+};
+
+/*!
+ * @brief Generates the stream described by @p streamConfig and writes it into an MP4 file.
+ *
+ * The access units are generated and written one by one. For MHM1 the config is written as MHAS
+ * config packet, so the AudioPreRoll of the IPFs never carries the config.
+ */
+SMp4Statistics writeMp4File(const SStreamConfig& streamConfig, const SMp4Config& mp4Config);
+}  // namespace generator
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
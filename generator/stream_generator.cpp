@@ -0,0 +1,144 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// System includes
+#include <algorithm>
+
+// External includes
+#include "ilo/logging.h"
+
+// Internal includes
+#include "stream_generator.h"
+
+using namespace mmt::au2mhasconverterlib;
+using namespace mmt::au2mhasconverterlib::generator;
+
+static constexpr size_t PAYLOAD_POOL_HEADROOM = 64 * 1024;
+
+CAccessUnitGenerator::CAccessUnitGenerator(const SStreamConfig& config)
+    : m_streamConfig(config), m_random(config.seed) {
+  ILO_ASSERT(config.meanFrameSize > config.frameSizeJitter,
+             "The frame size jitter must be smaller than the mean frame size.");
+  const uint32_t numSignalGroups =
+      config.configShape.numChannelGroups + config.configShape.numObjectGroups;
+  ILO_ASSERT(numSignalGroups >= 1 && numSignalGroups <= 32,
+             "The config needs between 1 and 32 signal groups, got %u.", numSignalGroups);
+  ILO_ASSERT(config.configShape.numExtElements >= 1,
+             "The config needs at least the AudioPreRoll extension element.");
+
+  m_config = buildConfig(config.configShape);
+
+  m_payloadPool.resize(config.meanFrameSize + config.frameSizeJitter + PAYLOAD_POOL_HEADROOM);
+  std::generate(m_payloadPool.begin(), m_payloadPool.end(),
+                [this] { return static_cast<uint8_t>(m_random.next() >> 56); });
+}
+
+uint32_t CAccessUnitGenerator::nextFrameSize() {
+  return m_random.uniform(m_streamConfig.meanFrameSize - m_streamConfig.frameSizeJitter,
+                          m_streamConfig.meanFrameSize + m_streamConfig.frameSizeJitter);
+}
+
+bool CAccessUnitGenerator::next(SAccessUnit& accessUnit) {
+  if (m_index >= m_streamConfig.numFrames) {
+    return false;
+  }
+
+  accessUnit.index = m_index;
+  accessUnit.isIpf = m_index == 0 ||
+                     (m_streamConfig.ipfInterval != 0 && m_index % m_streamConfig.ipfInterval == 0);
+
+  const uint32_t frameSize = nextFrameSize();
+  if (accessUnit.isIpf) {
+    const uint32_t preRollSize = nextFrameSize();
+    accessUnit.data =
+        buildIpf(m_streamConfig.embedConfigInIpf ? m_config : ByteBuffer{}, preRollSize, frameSize);
+  } else {
+    const size_t offset = m_random.uniform(0, static_cast<uint32_t>(PAYLOAD_POOL_HEADROOM));
+    accessUnit.data.assign(m_payloadPool.begin() + offset,
+                           m_payloadPool.begin() + offset + frameSize);
+    // usacIndependencyFlag not set, no AudioPreRoll payload present
+    accessUnit.data[0] = 0x00u;
+  }
+
+  ++m_index;
+  return true;
+}
@@ -0,0 +1,176 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/**
+ * @file stream_generator.h
+ *
+ * @brief Deterministic generator for synthetic MPEG-H 3DA access unit streams.
+ */
+#pragma once
+
+// System includes
+#include <cstdint>
+
+// Internal includes
+#include "bitstream_builder.h"
+
+namespace mmt {
+namespace au2mhasconverterlib {
+namespace generator {
+//! Deterministic pseudo random number generator (xorshift64*) with identical output everywhere.
+class CRandom {
+ public:
+  explicit CRandom(uint64_t seed) : m_state(seed != 0 ? seed : 0x9E3779B97F4A7C15ull) {}
+
+  //! Returns the next 64 bit random value.
+  uint64_t next() {
+    m_state ^= m_state >> 12;
+    m_state ^= m_state << 25;
+    m_state ^= m_state >> 27;
+    return m_state * 0x2545F4914F6CDD1Dull;
+  }
+
+  //! Returns a random value in the range [minimum, maximum].
+  uint32_t uniform(uint32_t minimum, uint32_t maximum) {
+    return minimum + static_cast<uint32_t>(next() % (uint64_t{maximum} - minimum + 1));
+  }
+
+ private:
+  uint64_t m_state;
+};
+
+//! Description of a synthetic access unit stream.
+struct SStreamConfig {
+  //! Shape of the stream config.
+  SConfigShape configShape;
+  //! Number of access units in the stream.
+  uint64_t numFrames = 1500;
+  //! Distance between two IPFs in frames, the first frame is always an IPF (0: only the first).
+  uint32_t ipfInterval = 50;
+  //! Whether the AudioPreRoll of the IPFs carries the config.
+  bool embedConfigInIpf = true;
+  //! Mean size of an access unit (and of the pre-roll access unit of an IPF) in bytes.
+  uint32_t meanFrameSize = 512;
+  //! Maximal deviation from the mean size in bytes, sizes are uniformly distributed.
+  uint32_t frameSizeJitter = 128;
+  //! Seed of the random number generator, equal seeds result in equal streams.
+  uint64_t seed = 1;
+};
+
+//! A generated access unit.
+struct SAccessUnit {
+  //! The raw mpegh3daFrame().
+  ByteBuffer data;
+  //! Index of the access unit in the stream.
+  uint64_t index = 0;
+  //! Whether the access unit is an Immediate Playout Frame.
+  bool isIpf = false;
+};
+
+/*!
+ * @brief Generates the access units of a synthetic stream one by one.
+ *
+ * The payload of the frames is copied from a pre-generated random pool, so generating long streams
+ * costs little more than copying the bytes.
+ */
+class CAccessUnitGenerator {
+ public:
+  explicit CAccessUnitGenerator(const SStreamConfig& config);
+
+  //! Returns the raw mpegh3daConfig() of the stream.
+  const ByteBuffer& config() const { return m_config; }
+
+  //! Generates the next access unit into @p accessUnit, returns false after the last one.
+  bool next(SAccessUnit& accessUnit);
+
+ private:
+  uint32_t nextFrameSize();
+
+  SStreamConfig m_streamConfig;
+  ByteBuffer m_config;
+  ByteBuffer m_payloadPool;
+  CRandom m_random;
+  uint64_t m_index = 0;
+};
+}  // namespace generator
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
@@ -0,0 +1,230 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/**
+ * @file async_log_sink.h
+ *
+ * @brief Non-blocking logging backend for concurrent conversions.
+ */
+#pragma once
+
+// System includes
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Internal includes
+#include "mmtau2mhasconverterlib/version.h"
+#include "mmtau2mhasconverterlib/events.h"
+
+namespace mmt {
+namespace au2mhasconverterlib {
+//! A log record as handed to the sink by the background thread.
+struct SLogRecord {
+  //! Maximum number of message bytes stored per record, longer messages are truncated.
+  static constexpr size_t MAX_MESSAGE_SIZE = 223;
+
+  //! Identifier of the job (e.g. file conversion) that produced the record.
+  uint64_t jobId = 0;
+  //! Time of the log call.
+  std::chrono::system_clock::time_point timestamp;
+  //! Whether the record carries a structured event (the message is its formatted text).
+  bool isEvent = false;
+  //! The structured event, valid if isEvent is set.
+  SEvent event;
+  //! Length of the message in bytes.
+  size_t messageSize = 0;
+  //! Message bytes, zero terminated.
+  char message[MAX_MESSAGE_SIZE + 1] = {};
+};
+
+/*!
+ * @brief Asynchronous log sink decoupling converting threads from slow log destinations.
+ *
+ * Every producing thread writes into its own lock-free single-producer ring buffer. A background
+ * thread drains all buffers and hands the records to the configured sink, so slow disks or syslog
+ * never block a conversion. The ring buffer of an exited thread is reused by the next new
+ * producing thread, so the number of buffers is bounded by the number of concurrent producers.
+ * Attach it to a conversion via the callbacks returned by logCallback() and eventCallback():
+ *
+ * ```{.c}
+ * CAsyncLogSink sink{CAsyncLogSink::SConfig{}};
+ * CFileConverter::SConfig config{};
+ * config.logCallback = sink.logCallback(jobId);
+ * ```
+ *
+ * Set as CDirectoryConverter::SConfig::asyncLogSink, it also receives the internal log messages
+ * of the library emitted by the file jobs (messages of the underlying libraries still go to the
+ * internal logging directly). The sink must outlive all conversions using its callbacks.
+ */
+class CAsyncLogSink {
+ public:
+  //! Behavior if the ring buffer of a producing thread is full.
+  enum class EOverflowPolicy {
+    //! Discard the new record and count it in droppedRecords() (never blocks).
+    DROP,
+    //! Wait until the background thread made room (never loses records).
+    BLOCK
+  };
+
+  //! The configuration structure for the creation of a new asynchronous log sink.
+  struct SConfig {
+    /*!
+     * @brief Destination of the records, called from the background thread only.
+     *
+     * By default, records are written to the internal logging (see log_redirect.h).
+     */
+    std::function<void(const SLogRecord&)> sink;
+    //! Number of records per producing thread, rounded up to a power of two.
+    size_t ringCapacity = 1024;
+    //! Behavior if a ring buffer is full.
+    EOverflowPolicy overflowPolicy = EOverflowPolicy::DROP;
+    //! Maximum time a record waits in a ring buffer before it is drained.
+    std::chrono::milliseconds drainInterval = std::chrono::milliseconds(50);
+  };
+
+  //! Creates the sink and starts the background thread.
+  explicit CAsyncLogSink(const SConfig& config);
+
+  //! Drains all pending records and stops the background thread.
+  ~CAsyncLogSink();
+
+  CAsyncLogSink(const CAsyncLogSink&) = delete;
+  CAsyncLogSink& operator=(const CAsyncLogSink&) = delete;
+
+  //! Enqueues a message from the calling thread without blocking (unless policy is BLOCK).
+  void log(uint64_t jobId, const std::string& message);
+
+  //! Enqueues a printf-style message, formatting it directly into the record (see log()).
+  void logFormatted(uint64_t jobId, const char* prefix, const char* format, va_list args);
+
+  //! Returns a callback suited for SConfigCommon::logCallback tagging records with the job ID.
+  std::function<void(const std::string&)> logCallback(uint64_t jobId);
+
+  //! Returns a callback suited for SConfigCommon::eventCallback tagging records with the job ID.
+  std::function<void(const SEvent&)> eventCallback(uint64_t jobId);
+
+  //! Blocks until all records enqueued before this call have been passed to the sink.
+  void flush();
+
+  //! Returns the number of records discarded due to full ring buffers.
+  uint64_t droppedRecords() const { return m_droppedRecords.load(std::memory_order_relaxed); }
+
+  //! Returns the number of ring buffers allocated so far.
+  size_t ringCount() const;
+
+ private:
+  struct SRing;
+  class CThreadRings;
+
+  SRing& threadRing();
+  SLogRecord* acquireSlot(SRing& ring);
+  void publishSlot(SRing& ring);
+  void wakeDrainThread();
+  void drainLoop();
+  void drainAll();
+
+  SConfig m_config;
+  const uint64_t m_instanceId;
+  mutable std::mutex m_ringsMutex;
+  //! Shared with the threads using them, see CThreadRings.
+  std::vector<std::shared_ptr<SRing>> m_rings;
+  std::vector<SRing*> m_drainSnapshot;
+  std::mutex m_wakeMutex;
+  std::condition_variable m_wakeCondition;
+  std::condition_variable m_drainedCondition;
+  bool m_wakeRequested = false;
+  bool m_stop = false;
+  uint64_t m_drainedRounds = 0;
+  std::atomic<uint64_t> m_droppedRecords{0};
+  std::thread m_drainThread;
+};
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
@@ -89,6 +89,7 @@ amm-info@iis.fraunhofer.de
 
 // System includes
 #include <memory>
+#include <string>
 #include <vector>
 
 // Internal includes
@@ -145,6 +146,100 @@ struct SMhasFrameOutput {
   bool isIndepFrame = false;
 };
 
+//! Restrictions of MPEG-H 3DA Baseline profile violated by a config.
+enum class SB_VIOLATIONS : uint32_t {
+  INVALID_PHASE_STRENGTH = 0,
+  SIGNAL_TYPE_HOA = 1,
+  SIGNAL_TYPE_SAOC = 2,
+  INVALID_QCE_INDEX = 3,
+  INVALID_LPD_STEREO_INDEX = 4,
+  INVALID_TW_MDCT_VALUE = 5,
+  INVALID_FULLBAND_LPD_VALUE = 6,
+  INVALID_CORE_MODE_VALUE = 7,
+  INVALID_COMMON_MAX_SFB_VALUE = 8,
+  INVALID_TNS_ON_LR_VALUE = 9,
+  INVALID_FAC_DATA_PRESENT_VALUE = 10
+};
+
+//! Result of the exception-free conversion functions.
+enum class EConversionStatus : uint32_t {
+  //! The packet was converted successfully.
+  OK = 0,
+  //! The frame does not contain any payload.
+  EMPTY_FRAME,
+  //! The config violates Baseline restrictions, see SConversionDiagnostics::violations.
+  NOT_BASELINE_COMPATIBLE,
+  //! The config does not signal a Low Complexity profile level.
+  UNSUPPORTED_PROFILE_LEVEL,
+  //! The config signals a coreSbrFrameLengthIndex that is not allowed in Low Complexity profile.
+  INVALID_CORE_SBR_FRAME_LENGTH_INDEX,
+  //! The IPF does not start with an AudioPreRoll extension element.
+  MISSING_AUDIO_PREROLL,
+  //! The IPF does not carry a config and no previous config is available.
+  MISSING_CONFIG,
+  //! The AudioPreRoll payload is longer than its signaled length.
+  INVALID_PAYLOAD_LENGTH,
+  //! The bitstream could not be parsed (e.g. truncated packet or unknown syntax element).
+  INVALID_BITSTREAM
+};
+
+//! Details about a failed conversion, filled by the exception-free conversion functions.
+struct SConversionDiagnostics {
+  //! The status of the last conversion.
+  EConversionStatus status = EConversionStatus::OK;
+  //! The found Baseline violations (only set for EConversionStatus::NOT_BASELINE_COMPATIBLE).
+  std::vector<SB_VIOLATIONS> violations;
+  //! The profile level of the config (only set for EConversionStatus::UNSUPPORTED_PROFILE_LEVEL).
+  uint8_t profileLevel = 0;
+  //! The parser error message (only set for EConversionStatus::INVALID_BITSTREAM).
+  std::string parserError;
+
+  //! Builds the human readable description of the status (the same text the throwing API uses).
+  std::string message() const;
+};
+
+//! Result of the validation of a MPEG-H 3DA config, see CConverter::validateConfig().
+struct SConfigValidation {
+  //! The status the conversion of the config would return.
+  EConversionStatus status = EConversionStatus::OK;
+  //! The found Baseline violations.
+  std::vector<SB_VIOLATIONS> violations;
+  //! The mpegh3daProfileLevelIndication of the config (not set if the config is unparsable).
+  SProfileLevel profileLevel;
+  //! The compatible profile level signaled by the converted config (only set if convertible).
+  SProfileLevel compatibleProfileLevel;
+  //! Whether the config carries an audio scene information config extension.
+  bool hasAsi = false;
+  //! The parser error message (only set for EConversionStatus::INVALID_BITSTREAM).
+  std::string parserError;
+};
+
+//! Running counters and timers of a converter instance.
+struct SConverterStatistics {
+  //! Number of converted MPEG-H 3DA frames (including IPFs).
+  uint64_t frames = 0;
+  //! Number of converted Immediate Playout Frames (IPF).
+  uint64_t ipfs = 0;
+  //! Number of converted MPEG-H 3DA configs (including configs embedded in IPFs).
+  uint64_t configConversions = 0;
+  //! Number of packet label changes caused by config changes.
+  uint64_t packetLabelRotations = 0;
+  //! Number of MPEG-H 3DA config and frame bytes passed to the converter.
+  uint64_t bytesIn = 0;
+  //! Number of MHAS packet bytes produced by the converter.
+  uint64_t bytesOut = 0;
+  //! Number of bytes copied through the bit-granular parser/writer path.
+  uint64_t bitwiseCopyBytes = 0;
+  //! Number of payload bytes copied as contiguous blocks into MHAS packets (without headers).
+  uint64_t bulkCopyBytes = 0;
+  //! Wall time spent in config conversion (including configs embedded in IPFs) in nanoseconds.
+  uint64_t convertConfigNs = 0;
+  //! Wall time spent in the conversion of regular frames in nanoseconds.
+  uint64_t convertFrameNs = 0;
+  //! Wall time spent in the conversion of IPFs (excluding the embedded config) in nanoseconds.
+  uint64_t convertIpfNs = 0;
+};
+
 //! The main converter interface.
 class CConverter {
  public:
@@ -163,17 +258,76 @@ class CConverter {
   //! Convert a single MPEG-H 3DA frame packet.
   SMhasFrameOutput convertFrame(const ByteBuffer& mpegh3daFrame);
 
+  /*!
+   * @brief Convert a single MPEG-H 3DA frame packet into @p output.
+   *
+   * The buffers of @p output are reused, so converting regular frames (no IPF) doesn't allocate
+   * once their capacity suffices.
+   */
+  void convertFrame(const ByteBuffer& mpegh3daFrame, SMhasFrameOutput& output);
+
+  /*!
+   * @brief Returns whether @p mpegh3daConfig is the config that was converted last.
+   *
+   * Converting this config again would not change the state of the converter.
+   */
+  bool isCurrentConfig(const ByteBuffer& mpegh3daConfig) const;
+
+  /*!
+   * @brief Convert a single MPEG-H 3DA config packet without throwing exceptions.
+   *
+   * @p output is only valid if EConversionStatus::OK is returned. On failure the converter state
+   * is not modified and the details are stored in the (optional) @p diagnostics.
+   *
+   * @note The config syntax is only bounds checked while it is walked: a truncated config still
+   * unwinds internally out of the bit parser and is reported as INVALID_BITSTREAM.
+   */
+  EConversionStatus tryConvertConfig(const ByteBuffer& mpegh3daConfig, SMhasConfigOutput& output,
+                                     SConversionDiagnostics* diagnostics = nullptr) noexcept;
+
+  /*!
+   * @brief Convert a single MPEG-H 3DA frame packet without throwing exceptions.
+   *
+   * @p output is only valid if EConversionStatus::OK is returned. On failure the details are stored
+   * in the (optional) @p diagnostics. A config embedded in a failing IPF might already be applied.
+   *
+   * The length fields of an AudioPreRoll are checked against the frame before it is parsed. The
+   * embedded config is handled like in tryConvertConfig().
+   */
+  EConversionStatus tryConvertFrame(const ByteBuffer& mpegh3daFrame, SMhasFrameOutput& output,
+                                    SConversionDiagnostics* diagnostics = nullptr) noexcept;
+
+  /*!
+   * @brief Validates a single MPEG-H 3DA config without converting it.
+   *
+   * Runs the same config walk as the conversion, but doesn't build any output. The result equals
+   * the status of a conversion with any converter instance.
+   */
+  static EConversionStatus validateConfig(const ByteBuffer& mpegh3daConfig,
+                                          SConfigValidation& result) noexcept;
+
   //! Returns the label of the last processed packet.
   uint32_t currentPacketLabel() const;
 
+  //! Returns the counters accumulated since the creation of this converter.
+  const SConverterStatistics& statistics() const { return m_statistics; }
+
  private:
-  SMhasFrameOutput convertIPF(const ByteBuffer& mpegh3daFrame);
+  EConversionStatus convertConfigChecked(const ByteBuffer& mpegh3daConfig,
+                                         SMhasConfigOutput& output,
+                                         SConversionDiagnostics* diagnostics);
+  EConversionStatus convertFrameChecked(const ByteBuffer& mpegh3daFrame, SMhasFrameOutput& output,
+                                        SConversionDiagnostics* diagnostics);
+  EConversionStatus convertIPF(const ByteBuffer& mpegh3daFrame, SMhasFrameOutput& output,
+                               SConversionDiagnostics* diagnostics);
 
   std::unique_ptr<ByteBuffer> m_currentConfig;
   std::unique_ptr<ByteBuffer> m_currentAsi;
+  ByteBuffer m_currentConfigInput;
   uint32_t m_currentPacketLabel = 0;
   uint64_t m_currentFrameNumber = 1;
   SConverterConfiguration m_config;
+  SConverterStatistics m_statistics;
 };
 }  // namespace au2mhasconverterlib
 }  // namespace mmt
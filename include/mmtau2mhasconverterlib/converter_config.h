@@ -88,6 +88,7 @@ amm-info@iis.fraunhofer.de
 #pragma once
 
 // System includes
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <string>
@@ -95,16 +96,44 @@ amm-info@iis.fraunhofer.de
 
 // Internal includes
 #include "mmtau2mhasconverterlib/version.h"
+#include "mmtau2mhasconverterlib/events.h"
 
 namespace mmt {
 namespace au2mhasconverterlib {
 using ByteBuffer = std::vector<uint8_t>;
 
+//! Handling of mhm1 input files that are already compliant, i.e. cleaning them changes no byte.
+enum class ECompliantInputHandling {
+  //! Convert the file like any other one (re-muxes it).
+  CONVERT,
+  //! Copy the input file to the output file (in the kernel, sharing the extents where supported).
+  COPY,
+  //! Write no output file.
+  SKIP
+};
+
 //! Common configuration fields.
 struct SConfigCommon {
   //! The function to be called for logging messages.
   std::function<void(const std::string&)> logCallback = [](const std::string&) {};
 
+  /*!
+   * @brief The function to be called for structured events subscribed to in eventMask.
+   *
+   * If empty (default), subscribed events are formatted as text and passed to the logCallback.
+   */
+  std::function<void(const SEvent&)> eventCallback;
+
+  /*!
+   * @brief Subscription mask of the events to emit, see eventBit().
+   *
+   * Subscribed events are passed to the eventCallback or, if none is set, formatted as text to
+   * the logCallback. Unsubscribed events cost neither string formatting nor the introspection
+   * needed for their values. By default, all events are emitted like the former log messages.
+   * Clients that don't need the per-sample events can restrict it to EVENT_MASK_PER_FILE.
+   */
+  uint32_t eventMask = EVENT_MASK_ALL;
+
   /*!
    * @brief The function to be called on progress updates.
    *
@@ -140,6 +169,54 @@ struct SConfigCommon {
 
   //! Flag whether to insert a MHAS sync packet into the output before every frame.
   bool insertSyncBeforeEveryFrame = false;
+
+  /*!
+   * @brief Path of an optional Chrome trace-event JSON file, an empty path disables tracing.
+   *
+   * The timeline contains spans for opening input and output, every sample conversion (with IPF
+   * and config change markers), the final writer flush and, in directory mode, every file job on
+   * the thread that processed it. It can be viewed with chrome://tracing or ui.perfetto.dev.
+   */
+  std::string traceFilePath = "";
+
+  /*!
+   * @brief Handling of mhm1 input files whose config packets are already compliant.
+   *
+   * Unless CONVERT, a pre-pass converts the distinct config packets of the file and compares them
+   * with the original ones. If nothing would change, the file is copied or skipped instead of being
+   * re-muxed. Files whose major brand, 'mhaP' box, edit list or track user data differ from what
+   * the conversion would write with the container level options (copyMhap, copyEditList, ...) are
+   * converted.
+   */
+  ECompliantInputHandling compliantMhmHandling = ECompliantInputHandling::CONVERT;
+
+  /*!
+   * @brief Number of input reads kept in flight ahead of the conversion, 0 disables prefetching.
+   *
+   * If the library is built with liburing (mmtau2mhasconverterlib_WITH_LIBURING), a background
+   * thread reads the input file through io_uring in chunks of inputPrefetchChunkSize bytes, so the
+   * sample reads of the converter are served from the page cache. Otherwise the kernel is asked to
+   * read ahead the input file. Either way, at most inputPrefetchDepth * inputPrefetchChunkSize
+   * bytes beyond the sample read by the converter are prefetched.
+   */
+  uint32_t inputPrefetchDepth = 0;
+
+  //! Size of the prefetch reads in bytes, see inputPrefetchDepth.
+  size_t inputPrefetchChunkSize = 1024 * 1024;
+
+  /*!
+   * @brief Flag whether to drop the input file from the page cache once it was processed (also if
+   * the conversion failed or was cancelled).
+   *
+   * Useful for batch conversions on shared hosts, where every input is read only once.
+   */
+  bool dropInputFromCache = false;
+
+  /*!
+   * @brief Flag whether to write back the output file while it is written (sync_file_range) and
+   * to drop the written data from the page cache.
+   */
+  bool writeBehindOutput = false;
 };
 }  // namespace au2mhasconverterlib
 }  // namespace mmt
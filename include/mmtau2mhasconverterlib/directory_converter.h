@@ -89,10 +89,12 @@ amm-info@iis.fraunhofer.de
 
 // System includes
 #include <functional>
+#include <memory>
 #include <string>
 
 // Internal includes
 #include "mmtau2mhasconverterlib/version.h"
+#include "async_log_sink.h"
 #include "converter_config.h"
 
 namespace mmt {
@@ -100,6 +102,14 @@ namespace au2mhasconverterlib {
 //! Batch converter for all matching files in a folder structure.
 class CDirectoryConverter {
  public:
+  //! Output formats of the per-file conversion report.
+  enum class EReportFormat {
+    //! JSON array with one object per file.
+    JSON,
+    //! Comma-separated values with a header line and one row per file.
+    CSV
+  };
+
   //! The configuration structure for the creation of a new directory converter.
   struct SConfig : SConfigCommon {
     //! The input folder/directory to convert files from.
@@ -115,6 +125,40 @@ class CDirectoryConverter {
 
     //! Flag whether to overwrite existing files or skip writing of already-existing output files.
     bool replaceFiles = true;
+
+    /*!
+     * @brief Path of the machine-readable per-file report, an empty path disables the report.
+     *
+     * Every file of the batch results in one record holding its status, input/output sizes,
+     * sample, IPF and config change counts, the wall time per stage (open, read, convert, write,
+     * publish), the throughput and the error text of failed conversions.
+     */
+    std::string reportFilePath = "";
+
+    //! Format of the per-file report.
+    EReportFormat reportFormat = EReportFormat::JSON;
+
+    /*!
+     * @brief Number of upcoming input files to prefetch, 0 disables the lookahead.
+     *
+     * While a file is converted, a background thread asks the kernel to read the metadata boxes
+     * (e.g. 'moov') and the first lookaheadMdatBytes of sample data of the next files, so their
+     * conversion doesn't start with the open latency of the storage (HDD, network file systems).
+     */
+    uint32_t lookaheadFiles = 0;
+
+    //! Number of sample data bytes prefetched per file, see lookaheadFiles.
+    uint64_t lookaheadMdatBytes = 1024 * 1024;
+
+    /*!
+     * @brief Optional asynchronous sink for the log messages and events of the file jobs.
+     *
+     * If set, it replaces logCallback and eventCallback within the file jobs and tags their
+     * records with the index of the file in the batch as job ID. The internal log messages of
+     * the library (see log_redirect.h) are enqueued in the sink as well while a job runs, so
+     * the converting threads never write to a log destination themselves.
+     */
+    std::shared_ptr<CAsyncLogSink> asyncLogSink;
   };
 
   //! Creates a new directory converter with the given configuration.
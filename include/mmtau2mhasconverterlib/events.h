@@ -0,0 +1,149 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/**
+ * @file events.h
+ *
+ * @brief Structured events emitted during file-based conversion.
+ */
+#pragma once
+
+// System includes
+#include <cstdint>
+#include <string>
+
+// Internal includes
+#include "mmtau2mhasconverterlib/version.h"
+
+namespace mmt {
+namespace au2mhasconverterlib {
+//! Codes of the structured conversion events, see SEvent::values for the attached values.
+enum class EEventCode : uint32_t {
+  //! Compatible profile level of the file-level config: values[0] = profile level.
+  PROFILE_LEVEL = 0,
+  //! The input file carries no MP4-level config, so the output will carry none either.
+  MISSING_FILE_CONFIG = 1,
+  //! The first sample is an independent frame but no IPF: values[0] = sample size in bytes.
+  FIRST_SAMPLE_NOT_IPF = 2,
+  //! A MHAS sync packet was inserted before the frame: values[0] = ESyncReason.
+  SYNC_INSERTED = 3,
+  //! A config packet was found in a MHM sample: values[0] = config payload size in bytes.
+  CONFIG_PACKET_FOUND = 4,
+  /*!
+   * Details of a config packet found in a MHM sample: values[0] = mpegh3daProfileLevelIndication,
+   * values[1] = CICP speaker layout index of the reference layout.
+   *
+   * Subscribing to this event requires an additional parse of every config packet.
+   */
+  CONFIG_PACKET_INFO = 5,
+};
+
+//! Reasons for the insertion of a MHAS sync packet (values[0] of EEventCode::SYNC_INSERTED).
+enum class ESyncReason : uint64_t { EVERY_FRAME = 0, FIRST_FRAME = 1, IPF = 2 };
+
+//! A structured conversion event.
+struct SEvent {
+  //! The kind of event.
+  EEventCode code = EEventCode::PROFILE_LEVEL;
+  //! Zero-based index of the sample the event refers to (0 for file-level events).
+  uint64_t sampleIndex = 0;
+  //! Numeric event values, meaning depends on the event code.
+  uint64_t values[2] = {0, 0};
+};
+
+//! Returns the subscription mask bit of the given event code.
+constexpr uint32_t eventBit(EEventCode code) {
+  return 1u << static_cast<uint32_t>(code);
+}
+
+//! Subscription mask of all events.
+constexpr uint32_t EVENT_MASK_ALL = 0xFFFFFFFFu;
+
+//! Subscription mask of the events occurring at most once per file.
+constexpr uint32_t EVENT_MASK_PER_FILE = eventBit(EEventCode::PROFILE_LEVEL) |
+                                         eventBit(EEventCode::MISSING_FILE_CONFIG) |
+                                         eventBit(EEventCode::FIRST_SAMPLE_NOT_IPF);
+
+//! Formats the given event as human readable log message.
+std::string formatEvent(const SEvent& event);
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
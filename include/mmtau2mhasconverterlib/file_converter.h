@@ -93,12 +93,41 @@ amm-info@iis.fraunhofer.de
 
 // Internal includes
 #include "mmtau2mhasconverterlib/version.h"
+#include "converter.h"
 #include "converter_config.h"
 
 namespace mmt {
 namespace au2mhasconverterlib {
 class CFileConverterPimpl;
 
+//! Statistics of a single file conversion.
+struct SFileConversionStatistics {
+  //! Counters and timers of the converter processing the MPEG-H payload of the track.
+  SConverterStatistics converter;
+  //! Number of processed samples.
+  uint64_t samples = 0;
+  //! Number of random access samples (IPFs in mha1 input, samples with config packets in mhm1).
+  uint64_t ipfs = 0;
+  //! Number of samples after which the MHAS packet label changed.
+  uint64_t configChanges = 0;
+  //! Number of sample payload bytes read from the input file.
+  uint64_t bytesIn = 0;
+  //! Number of sample payload bytes passed to the output file.
+  uint64_t bytesOut = 0;
+  //! Wall time for opening input and output and converting the file-level config in nanoseconds.
+  uint64_t openNs = 0;
+  //! Wall time spent reading samples in nanoseconds.
+  uint64_t readNs = 0;
+  //! Wall time spent converting samples (converter and sample assembly) in nanoseconds.
+  uint64_t convertNs = 0;
+  //! Part of convertNs spent outside of the converter, assembling the output samples.
+  uint64_t sampleAssemblyNs = 0;
+  //! Wall time spent writing samples and finalizing the output file in nanoseconds.
+  uint64_t writeNs = 0;
+  //! Whether the input was already compliant and copied or skipped, see compliantMhmHandling.
+  bool compliantInput = false;
+};
+
 //! Converter object for file-based conversion.
 class CFileConverter {
  public:
@@ -119,6 +148,13 @@ class CFileConverter {
   //! Runs the actual conversion.
   void process();
 
+  /*!
+   * @brief Returns the statistics of the last call to process().
+   *
+   * If process() failed or was interrupted, the statistics cover the samples processed until then.
+   */
+  const SFileConversionStatistics& statistics() const;
+
   //! Returns the version of this converter library.
   std::string getVersion() const;
 
@@ -0,0 +1,176 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/**
+ * @file file_probe.h
+ *
+ * @brief Interface for the validation-only probing of MP4 files.
+ */
+#pragma once
+
+// System includes
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Internal includes
+#include "mmtau2mhasconverterlib/version.h"
+#include "converter.h"
+#include "converter_config.h"
+
+namespace mmt {
+namespace au2mhasconverterlib {
+//! Result of probing a single file, see CFileProbe.
+struct SFileProbeReport {
+  //! Whether the track is a mhm1 (MHAS) track, otherwise it is a mha1 track.
+  bool isMhm = false;
+  //! Whether the sample entry carries a MPEG-H 3DA config (mhaC box).
+  bool hasFileConfig = false;
+  //! Validation of the sample entry config (only valid if hasFileConfig is set).
+  SConfigValidation fileConfig;
+  /*!
+   * @brief Validation of the distinct in-band configs in order of their first occurrence.
+   *
+   * In-band configs are the AudioPreRoll configs of the IPFs in mha1 tracks and the config
+   * packets in mhm1 tracks. Configs equal to the sample entry config are not repeated.
+   */
+  std::vector<SConfigValidation> inBandConfigs;
+  //! Number of inspected samples, see CFileProbe::SConfig::maxSamples.
+  uint64_t samples = 0;
+  //! Whether all samples of the track were inspected (not limited or interrupted).
+  bool complete = false;
+  //! Number of random access samples (IPFs in mha1, samples with config packets in mhm1).
+  uint64_t ipfs = 0;
+  //! Index of the first random access sample (equals samples if there is none).
+  uint64_t firstIpf = 0;
+  //! Minimal distance of two consecutive random access samples in samples (0: less than two).
+  uint64_t minIpfDistance = 0;
+  //! Maximal distance of two consecutive random access samples in samples (0: less than two).
+  uint64_t maxIpfDistance = 0;
+  //! Number of samples carrying an in-band config that differs from the previous config.
+  uint64_t configChanges = 0;
+  //! Number of IPFs whose AudioPreRoll exceeds the sample (not counted as random access samples).
+  uint64_t truncatedIpfs = 0;
+  //! Index of the first truncated IPF (only valid if truncatedIpfs is not 0).
+  uint64_t firstTruncatedIpf = 0;
+
+  //! Returns whether all found configs and IPFs can be converted.
+  bool isConvertible() const;
+};
+
+/*!
+ * @brief Probe object checking whether a file can be converted, without converting it.
+ *
+ * Only the configs of the file are validated (see CConverter::validateConfig()), the samples are
+ * merely inspected for IPFs and in-band configs. No output is written.
+ */
+class CFileProbe {
+ public:
+  //! The configuration structure for the creation of a new file probe.
+  struct SConfig : SConfigCommon {
+    //! The input file to probe.
+    std::string inputFile;
+    /*!
+     * @brief Maximal number of samples to inspect for IPFs and in-band configs (0: all samples).
+     *
+     * By default, all samples are inspected. If limited, the counts of the report only cover the
+     * inspected prefix of the track.
+     */
+    uint64_t maxSamples = 0;
+  };
+
+  //! Creates a new file probe with the given configuration.
+  explicit CFileProbe(const SConfig& config);
+
+  /*!
+   * @brief Probes the input file.
+   *
+   * Throws if the file can't be read. If interrupted or limited by SConfig::maxSamples, the report
+   * covers the samples inspected until then.
+   */
+  SFileProbeReport probe();
+
+ private:
+  SConfig m_config;
+};
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
@@ -0,0 +1,403 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// System includes
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+// Internal includes
+#include "mmtau2mhasconverterlib/async_log_sink.h"
+#include "logging.h"
+
+namespace mmt {
+namespace au2mhasconverterlib {
+constexpr size_t SLogRecord::MAX_MESSAGE_SIZE;
+
+//! Lock-free single-producer/single-consumer ring buffer owned by one producing thread.
+struct CAsyncLogSink::SRing {
+  explicit SRing(size_t capacity) : records(capacity), mask(capacity - 1) {}
+
+  std::vector<SLogRecord> records;
+  const size_t mask;
+  //! Next slot to write, only modified by the producer.
+  std::atomic<size_t> head{0};
+  //! Next slot to read, only modified by the background thread.
+  std::atomic<size_t> tail{0};
+  //! Whether a living thread produces into the ring, only claimed under m_ringsMutex.
+  std::atomic<bool> owned{true};
+  //! Set when the sink is destroyed, so the producing thread releases its reference.
+  std::atomic<bool> orphaned{false};
+};
+
+//! The rings of the calling thread per sink instance, handed back to the sinks on thread exit.
+class CAsyncLogSink::CThreadRings {
+ public:
+  CThreadRings() = default;
+  CThreadRings(const CThreadRings&) = delete;
+  CThreadRings& operator=(const CThreadRings&) = delete;
+
+  ~CThreadRings() {
+    for (const auto& entry : m_entries) {
+      entry.second->owned.store(false, std::memory_order_release);
+    }
+  }
+
+  SRing* find(uint64_t instanceId) const {
+    for (const auto& entry : m_entries) {
+      if (entry.first == instanceId) {
+        return entry.second.get();
+      }
+    }
+    return nullptr;
+  }
+
+  void add(uint64_t instanceId, std::shared_ptr<SRing> ring) {
+    // Instance IDs are never reused, so the rings of destroyed sinks can be dropped
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                   [](const std::pair<uint64_t, std::shared_ptr<SRing>>& entry) {
+                                     return entry.second->orphaned.load(std::memory_order_acquire);
+                                   }),
+                    m_entries.end());
+    m_entries.emplace_back(instanceId, std::move(ring));
+  }
+
+ private:
+  std::vector<std::pair<uint64_t, std::shared_ptr<SRing>>> m_entries;
+};
+
+static size_t roundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+static uint64_t nextInstanceId() {
+  static std::atomic<uint64_t> instanceCounter{0};
+  return ++instanceCounter;
+}
+
+CAsyncLogSink::CAsyncLogSink(const SConfig& config)
+    : m_config(config), m_instanceId(nextInstanceId()) {
+  m_config.ringCapacity = roundUpToPowerOfTwo(std::max<size_t>(m_config.ringCapacity, 2));
+  if (!m_config.sink) {
+    // note: records were explicitly requested by the client, so they bypass the compile-time
+    // filter of the internal diagnostics
+    m_config.sink = [](const SLogRecord& record) {
+      ILO_LOG_INFO("[job %" PRIu64 "] %s", record.jobId, record.message);
+    };
+  }
+  m_drainThread = std::thread(&CAsyncLogSink::drainLoop, this);
+}
+
+CAsyncLogSink::~CAsyncLogSink() {
+  {
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    m_stop = true;
+  }
+  m_wakeCondition.notify_one();
+  m_drainThread.join();
+
+  std::lock_guard<std::mutex> lock(m_ringsMutex);
+  for (const auto& ring : m_rings) {
+    ring->orphaned.store(true, std::memory_order_release);
+  }
+}
+
+CAsyncLogSink::SRing& CAsyncLogSink::threadRing() {
+  thread_local CThreadRings threadRings;
+  if (SRing* ring = threadRings.find(m_instanceId)) {
+    return *ring;
+  }
+
+  std::shared_ptr<SRing> ring;
+  {
+    std::lock_guard<std::mutex> lock(m_ringsMutex);
+    // A released ring has no producer anymore, the new one continues at its head
+    for (const auto& candidate : m_rings) {
+      if (!candidate->owned.load(std::memory_order_acquire)) {
+        candidate->owned.store(true, std::memory_order_relaxed);
+        ring = candidate;
+        break;
+      }
+    }
+    if (!ring) {
+      m_rings.push_back(std::make_shared<SRing>(m_config.ringCapacity));
+      ring = m_rings.back();
+    }
+  }
+  threadRings.add(m_instanceId, ring);
+  return *ring;
+}
+
+size_t CAsyncLogSink::ringCount() const {
+  std::lock_guard<std::mutex> lock(m_ringsMutex);
+  return m_rings.size();
+}
+
+SLogRecord* CAsyncLogSink::acquireSlot(SRing& ring) {
+  const size_t head = ring.head.load(std::memory_order_relaxed);
+  while (head - ring.tail.load(std::memory_order_acquire) >= ring.records.size()) {
+    if (m_config.overflowPolicy == EOverflowPolicy::DROP) {
+      m_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    wakeDrainThread();
+    std::this_thread::yield();
+  }
+  return &ring.records[head & ring.mask];
+}
+
+void CAsyncLogSink::publishSlot(SRing& ring) {
+  const size_t head = ring.head.load(std::memory_order_relaxed) + 1;
+  ring.head.store(head, std::memory_order_release);
+  // Do not wait for the drain interval if the ring is filling up
+  if (head - ring.tail.load(std::memory_order_relaxed) > ring.records.size() / 2) {
+    wakeDrainThread();
+  }
+}
+
+void CAsyncLogSink::log(uint64_t jobId, const std::string& message) {
+  SRing& ring = threadRing();
+  SLogRecord* record = acquireSlot(ring);
+  if (record == nullptr) {
+    return;
+  }
+  record->jobId = jobId;
+  record->timestamp = std::chrono::system_clock::now();
+  record->isEvent = false;
+  record->messageSize = std::min(message.size(), SLogRecord::MAX_MESSAGE_SIZE);
+  std::memcpy(record->message, message.data(), record->messageSize);
+  record->message[record->messageSize] = '\0';
+  publishSlot(ring);
+}
+
+void CAsyncLogSink::logFormatted(uint64_t jobId, const char* prefix, const char* format,
+                                 va_list args) {
+  SRing& ring = threadRing();
+  SLogRecord* record = acquireSlot(ring);
+  if (record == nullptr) {
+    return;
+  }
+  record->jobId = jobId;
+  record->timestamp = std::chrono::system_clock::now();
+  record->isEvent = false;
+  const size_t prefixSize = std::min(std::strlen(prefix), SLogRecord::MAX_MESSAGE_SIZE);
+  std::memcpy(record->message, prefix, prefixSize);
+  const int written = std::vsnprintf(record->message + prefixSize,
+                                     SLogRecord::MAX_MESSAGE_SIZE + 1 - prefixSize, format, args);
+  const size_t formattedSize = written > 0 ? static_cast<size_t>(written) : 0;
+  record->messageSize = std::min(prefixSize + formattedSize, SLogRecord::MAX_MESSAGE_SIZE);
+  record->message[record->messageSize] = '\0';
+  publishSlot(ring);
+}
+
+std::function<void(const std::string&)> CAsyncLogSink::logCallback(uint64_t jobId) {
+  return [this, jobId](const std::string& message) { log(jobId, message); };
+}
+
+std::function<void(const SEvent&)> CAsyncLogSink::eventCallback(uint64_t jobId) {
+  return [this, jobId](const SEvent& event) {
+    SRing& ring = threadRing();
+    SLogRecord* record = acquireSlot(ring);
+    if (record == nullptr) {
+      return;
+    }
+    // note: the text is formatted by the background thread
+    record->jobId = jobId;
+    record->timestamp = std::chrono::system_clock::now();
+    record->isEvent = true;
+    record->event = event;
+    record->messageSize = 0;
+    publishSlot(ring);
+  };
+}
+
+void CAsyncLogSink::wakeDrainThread() {
+  {
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    m_wakeRequested = true;
+  }
+  m_wakeCondition.notify_one();
+}
+
+void CAsyncLogSink::flush() {
+  std::unique_lock<std::mutex> lock(m_wakeMutex);
+  // Wait for a complete round that started after this call
+  const uint64_t targetRound = m_drainedRounds + 2;
+  m_wakeRequested = true;
+  m_wakeCondition.notify_one();
+  m_drainedCondition.wait(lock, [&] { return m_drainedRounds >= targetRound || m_stop; });
+}
+
+void CAsyncLogSink::drainLoop() {
+  std::unique_lock<std::mutex> lock(m_wakeMutex);
+  while (true) {
+    m_wakeCondition.wait_for(lock, m_config.drainInterval,
+                             [this] { return m_wakeRequested || m_stop; });
+    const bool stop = m_stop;
+    m_wakeRequested = false;
+    lock.unlock();
+
+    drainAll();
+
+    lock.lock();
+    ++m_drainedRounds;
+    m_drainedCondition.notify_all();
+    if (stop) {
+      break;
+    }
+  }
+}
+
+void CAsyncLogSink::drainAll() {
+  {
+    std::lock_guard<std::mutex> lock(m_ringsMutex);
+    m_drainSnapshot.clear();
+    for (const auto& ring : m_rings) {
+      m_drainSnapshot.push_back(ring.get());
+    }
+  }
+
+  for (SRing* ring : m_drainSnapshot) {
+    size_t tail = ring->tail.load(std::memory_order_relaxed);
+    const size_t head = ring->head.load(std::memory_order_acquire);
+    while (tail != head) {
+      SLogRecord& record = ring->records[tail & ring->mask];
+      if (record.isEvent) {
+        std::string message = formatEvent(record.event);
+        record.messageSize = std::min(message.size(), SLogRecord::MAX_MESSAGE_SIZE);
+        std::memcpy(record.message, message.data(), record.messageSize);
+        record.message[record.messageSize] = '\0';
+      }
+      try {
+        m_config.sink(record);
+      } catch (...) {
+        // A failing sink must not terminate the background thread
+      }
+      ++tail;
+      ring->tail.store(tail, std::memory_order_release);
+    }
+  }
+}
+
+namespace logging {
+//! The log sink installed for the calling thread and the job ID of its records.
+struct SThreadLogSink {
+  CAsyncLogSink* sink = nullptr;
+  uint64_t jobId = 0;
+};
+
+static SThreadLogSink& threadLogSink() {
+  thread_local SThreadLogSink threadSink;
+  return threadSink;
+}
+
+bool logToThreadSink(const char* prefix, const char* format, ...) {
+  const SThreadLogSink& threadSink = threadLogSink();
+  if (threadSink.sink == nullptr) {
+    return false;
+  }
+  va_list args;
+  va_start(args, format);
+  threadSink.sink->logFormatted(threadSink.jobId, prefix, format, args);
+  va_end(args);
+  return true;
+}
+
+CThreadLogSinkScope::CThreadLogSinkScope(CAsyncLogSink* sink, uint64_t jobId)
+    : m_previousSink(threadLogSink().sink), m_previousJobId(threadLogSink().jobId) {
+  threadLogSink().sink = sink;
+  threadLogSink().jobId = jobId;
+}
+
+CThreadLogSinkScope::~CThreadLogSinkScope() {
+  threadLogSink().sink = m_previousSink;
+  threadLogSink().jobId = m_previousJobId;
+}
+}  // namespace logging
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
@@ -0,0 +1,197 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// External includes
+#include "mmtmhasparserlib/mhasutilities.h"
+
+// Internal includes
+#include "audio_preroll.h"
+
+using namespace mmt::au2mhasconverterlib;
+
+//! usacIndependencyFlag, usacExtElementPresent and !usacExtElementUseDefaultLength
+static constexpr uint8_t AUDIO_PREROLL_FLAGS = 6;
+
+static uint32_t readExtElementPayloadLength(ilo::CBitParser& parser) {
+  auto value = parser.read<uint32_t>(8);
+  if (value == 255) {
+    auto tmpValue = parser.read<uint16_t>(16);
+    value += tmpValue - 2;
+  }
+  return value;
+}
+
+namespace {
+//! Reads MSB first from a byte buffer, a read past the end only clears the valid flag.
+class CCheckedBitReader {
+ public:
+  explicit CCheckedBitReader(const ilo::ByteBuffer& buffer) : m_buffer(buffer) {}
+
+  uint64_t read(uint32_t numBits) {
+    if (!skip(numBits)) {
+      return 0;
+    }
+    uint64_t value = 0;
+    for (uint64_t bit = m_position - numBits; bit < m_position; ++bit) {
+      value = (value << 1) | ((m_buffer[bit / 8] >> (7 - bit % 8)) & 1u);
+    }
+    return value;
+  }
+
+  //! escapedValue() of ISO/IEC 23008-3
+  uint64_t readEscapedValue(uint32_t nBits1, uint32_t nBits2, uint32_t nBits3) {
+    uint64_t value = read(nBits1);
+    if (value == (1ull << nBits1) - 1) {
+      uint64_t valueAdd = read(nBits2);
+      value += valueAdd;
+      if (valueAdd == (1ull << nBits2) - 1) {
+        value += read(nBits3);
+      }
+    }
+    return value;
+  }
+
+  bool skip(uint64_t numBits) {
+    if (!m_valid || numBits > nofBits() - m_position) {
+      m_valid = false;
+      return false;
+    }
+    m_position += numBits;
+    return true;
+  }
+
+  uint64_t nofBits() const { return static_cast<uint64_t>(m_buffer.size()) * 8; }
+  uint64_t tell() const { return m_position; }
+  bool valid() const { return m_valid; }
+
+ private:
+  const ilo::ByteBuffer& m_buffer;
+  uint64_t m_position = 0;
+  bool m_valid = true;
+};
+}  // namespace
+
+bool mmt::au2mhasconverterlib::startsWithAudioPreRoll(const ilo::ByteBuffer& mpegh3daFrame) {
+  return !mpegh3daFrame.empty() && (mpegh3daFrame[0] & 0xE0u) == (AUDIO_PREROLL_FLAGS << 5);
+}
+
+bool mmt::au2mhasconverterlib::readAudioPreRollHeader(ilo::CBitParser& parser,
+                                                      SAudioPreRollHeader& header) {
+  if (parser.read<uint8_t>(3) != AUDIO_PREROLL_FLAGS) {
+    return false;
+  }
+
+  header.payloadLength = readExtElementPayloadLength(parser);
+  header.payloadBegin = parser.tell();
+
+  auto configLength = static_cast<uint32_t>(mmt::mhasparserlib::readEscapedValue(parser, 4, 4, 8));
+  header.config.resize(configLength);
+  for (uint32_t i = 0; i < configLength; ++i) {
+    header.config[i] = parser.read<uint8_t>(8);
+  }
+  return true;
+}
+
+bool mmt::au2mhasconverterlib::audioPreRollFitsInFrame(
+    const ilo::ByteBuffer& mpegh3daFrame) noexcept {
+  CCheckedBitReader reader(mpegh3daFrame);
+  if (reader.read(3) != AUDIO_PREROLL_FLAGS) {
+    return false;
+  }
+
+  uint64_t payloadLength = reader.read(8);
+  if (payloadLength == 255) {
+    payloadLength = 253 + reader.read(16);
+  }
+  if (!reader.valid() || payloadLength * 8 > reader.nofBits() - reader.tell()) {
+    return false;
+  }
+
+  reader.skip(reader.readEscapedValue(4, 4, 8) * 8);
+  // applyCrossfade and reserved
+  reader.skip(2);
+  uint64_t numPrerollFrames = reader.readEscapedValue(2, 4, 0);
+  for (uint64_t i = 0; i < numPrerollFrames && reader.valid(); ++i) {
+    reader.skip(reader.readEscapedValue(16, 16, 0) * 8);
+  }
+  return reader.valid();
+}
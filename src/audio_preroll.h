@@ -0,0 +1,132 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/**
+ * @file audio_preroll.h
+ *
+ * @brief Parsing of the AudioPreRoll extension element at the start of IPFs.
+ */
+#pragma once
+
+// System includes
+#include <cstdint>
+
+// External includes
+#include "ilo/bitparser.h"
+#include "ilo/common_types.h"
+
+// Internal includes
+#include "mmtau2mhasconverterlib/version.h"
+
+namespace mmt {
+namespace au2mhasconverterlib {
+//! Leading fields of an AudioPreRoll() up to the embedded config.
+struct SAudioPreRollHeader {
+  //! The usacExtElementPayloadLength in bytes.
+  uint32_t payloadLength = 0;
+  //! Bit position of the start of the AudioPreRoll() payload in the frame.
+  uint32_t payloadBegin = 0;
+  //! The embedded Config() (empty if configLen is 0).
+  ilo::ByteBuffer config;
+};
+
+//! Returns whether the mpegh3daFrame @p mpegh3daFrame starts with an AudioPreRoll (is an IPF).
+bool startsWithAudioPreRoll(const ilo::ByteBuffer& mpegh3daFrame);
+
+/*!
+ * @brief Reads the leading fields of the AudioPreRoll at the start of a mpegh3daFrame.
+ *
+ * @p parser has to be positioned at the start of the frame. Returns false if the frame does not
+ * start with an AudioPreRoll, otherwise @p parser is left at the applyCrossfade field.
+ */
+bool readAudioPreRollHeader(ilo::CBitParser& parser, SAudioPreRollHeader& header);
+
+/*!
+ * @brief Checks the length fields of the AudioPreRoll at the start of a mpegh3daFrame.
+ *
+ * Returns whether the extension payload, the embedded config and all pre-roll AUs end within
+ * @p mpegh3daFrame, so that the AudioPreRoll can be rewritten without reading past the frame.
+ * Doesn't throw, the frame is only read through a bounds checked reader.
+ */
+bool audioPreRollFitsInFrame(const ilo::ByteBuffer& mpegh3daFrame) noexcept;
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
@@ -0,0 +1,169 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// System includes
+#include <cstdio>
+#include <string>
+
+// Internal includes
+#include "conversion_report.h"
+#include "helpers.h"
+#include "logging.h"
+
+namespace mmt {
+namespace au2mhasconverterlib {
+static std::string escapeCsv(const std::string& in) {
+  if (in.find_first_of(",\"\r\n") == std::string::npos) {
+    return in;
+  }
+  std::string out = "\"";
+  for (char c : in) {
+    if (c == '"') {
+      out += '"';
+    }
+    out += c;
+  }
+  return out + "\"";
+}
+
+//! Throughput of the whole file job in megabytes (10^6 bytes) of input per second.
+static std::string throughput(const SConversionReportEntry& entry) {
+  uint64_t totalNs =
+      entry.openNs + entry.readNs + entry.convertNs + entry.writeNs + entry.publishNs;
+  double megabytesPerSecond =
+      totalNs == 0 ? 0.0 : (static_cast<double>(entry.inputBytes) * 1000.0) / totalNs;
+  char formatted[32];
+  std::snprintf(formatted, sizeof(formatted), "%.3f", megabytesPerSecond);
+  return formatted;
+}
+
+CConversionReport::CConversionReport(const std::string& filePath,
+                                     CDirectoryConverter::EReportFormat format)
+    : m_file(filePath, std::ios::out | std::ios::trunc), m_format(format) {
+  ILO_ASSERT(m_file.good(), "Opening report file %s failed", filePath.c_str());
+  if (m_format == CDirectoryConverter::EReportFormat::JSON) {
+    m_file << "[";
+  } else {
+    m_file << "input_file,output_file,status,input_bytes,output_bytes,samples,ipfs,"
+              "config_changes,open_ns,read_ns,convert_ns,write_ns,publish_ns,throughput_mbps,"
+              "error\n";
+  }
+  m_file.flush();
+}
+
+CConversionReport::~CConversionReport() {
+  if (m_format == CDirectoryConverter::EReportFormat::JSON) {
+    m_file << (m_firstEntry ? "]\n" : "\n]\n");
+  }
+}
+
+void CConversionReport::add(const SConversionReportEntry& entry) {
+  if (m_format == CDirectoryConverter::EReportFormat::JSON) {
+    m_file << (m_firstEntry ? "\n" : ",\n");
+    m_file << "  {\"inputFile\": \"" << escapeJsonString(entry.inputFile) << "\", ";
+    m_file << "\"outputFile\": \"" << escapeJsonString(entry.outputFile) << "\", ";
+    m_file << "\"status\": \"" << entry.status << "\", ";
+    m_file << "\"inputBytes\": " << entry.inputBytes << ", ";
+    m_file << "\"outputBytes\": " << entry.outputBytes << ", ";
+    m_file << "\"samples\": " << entry.samples << ", ";
+    m_file << "\"ipfs\": " << entry.ipfs << ", ";
+    m_file << "\"configChanges\": " << entry.configChanges << ", ";
+    m_file << "\"openNs\": " << entry.openNs << ", ";
+    m_file << "\"readNs\": " << entry.readNs << ", ";
+    m_file << "\"convertNs\": " << entry.convertNs << ", ";
+    m_file << "\"writeNs\": " << entry.writeNs << ", ";
+    m_file << "\"publishNs\": " << entry.publishNs << ", ";
+    m_file << "\"throughputMBps\": " << throughput(entry) << ", ";
+    m_file << "\"error\": \"" << escapeJsonString(entry.error) << "\"}";
+  } else {
+    m_file << escapeCsv(entry.inputFile) << "," << escapeCsv(entry.outputFile) << ","
+           << entry.status << "," << entry.inputBytes << "," << entry.outputBytes << ","
+           << entry.samples << "," << entry.ipfs << "," << entry.configChanges << ","
+           << entry.openNs << "," << entry.readNs << "," << entry.convertNs << ","
+           << entry.writeNs << "," << entry.publishNs << "," << throughput(entry) << ","
+           << escapeCsv(entry.error) << "\n";
+  }
+  m_firstEntry = false;
+  m_file.flush();
+}
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
@@ -84,6 +84,7 @@ amm-info@iis.fraunhofer.de
 #include <algorithm>
 #include <cinttypes>
 #include <cmath>
+#include <cstring>
 #include <string>
 
 // External includes
@@ -99,8 +100,11 @@ amm-info@iis.fraunhofer.de
 // Internal includes
 #include "mmtau2mhasconverterlib/converter.h"
 #include "mmtau2mhasconverterlib/log_redirect.h"
+#include "audio_preroll.h"
 #include "converter_helpers.h"
 #include "logging.h"
+#include "probes.h"
+#include "stopwatch.h"
 
 using namespace mmt::au2mhasconverterlib;
 
@@ -110,20 +114,6 @@ static constexpr uint32_t ID_EXT_ELE_AUDIOPREROLL = 3;
 static constexpr uint32_t ID_CONFIG_EXT_AUDIOSCENE_INFO = 3;
 static constexpr uint32_t ID_CONFIG_EXT_COMPATIBLE_PROFILELVL_SET = 7;
 
-enum class SB_VIOLATIONS : uint32_t {
-  INVALID_PHASE_STRENGTH = 0,
-  SIGNAL_TYPE_HOA = 1,
-  SIGNAL_TYPE_SAOC = 2,
-  INVALID_QCE_INDEX = 3,
-  INVALID_LPD_STEREO_INDEX = 4,
-  INVALID_TW_MDCT_VALUE = 5,
-  INVALID_FULLBAND_LPD_VALUE = 6,
-  INVALID_CORE_MODE_VALUE = 7,
-  INVALID_COMMON_MAX_SFB_VALUE = 8,
-  INVALID_TNS_ON_LR_VALUE = 9,
-  INVALID_FAC_DATA_PRESENT_VALUE = 10
-};
-
 /*! According to ISO/IEC 23008-3, value table for mpegh3daProfileLevelIndication */
 enum ProfileLevels : uint8_t {
   MAIN_LEVEL_1 = 0x01,
@@ -159,7 +149,65 @@ static std::string errorMessage(const std::vector<SB_VIOLATIONS>& violations) {
   return std::string("Error parsing config, bitstream is not baseline compatible: ") + errors;
 }
 
+std::string SConversionDiagnostics::message() const {
+  switch (status) {
+    case EConversionStatus::OK:
+      return "No error.";
+    case EConversionStatus::EMPTY_FRAME:
+      return "Frame does not contain any payload";
+    case EConversionStatus::NOT_BASELINE_COMPATIBLE:
+      return errorMessage(violations);
+    case EConversionStatus::UNSUPPORTED_PROFILE_LEVEL:
+      return "Only LC bitstreams are supported, found profile level: " +
+             std::to_string(static_cast<int>(profileLevel));
+    case EConversionStatus::INVALID_CORE_SBR_FRAME_LENGTH_INDEX:
+      return "Invalid LC config found.";
+    case EConversionStatus::MISSING_AUDIO_PREROLL:
+      return "Frame does not contain any AudioPreRoll.";
+    case EConversionStatus::MISSING_CONFIG:
+      return "No AudioPreRoll config found and no config available.";
+    case EConversionStatus::INVALID_PAYLOAD_LENGTH:
+      return "Invalid extension segment payload length detected.";
+    case EConversionStatus::INVALID_BITSTREAM:
+      return parserError.empty() ? "Error parsing bitstream." : parserError;
+  }
+  return "Unknown conversion status.";
+}
+
+static void resetDiagnostics(SConversionDiagnostics* diagnostics) noexcept {
+  if (diagnostics) {
+    // keep the allocated buffers for the next failure
+    diagnostics->status = EConversionStatus::OK;
+    diagnostics->violations.clear();
+    diagnostics->profileLevel = 0;
+    diagnostics->parserError.clear();
+  }
+}
+
+static EConversionStatus reportFailure(SConversionDiagnostics* diagnostics,
+                                       EConversionStatus status) {
+  if (diagnostics) {
+    diagnostics->status = status;
+  }
+  return status;
+}
+
+static EConversionStatus reportParserError(SConversionDiagnostics* diagnostics,
+                                           const char* what) noexcept {
+  if (diagnostics) {
+    diagnostics->status = EConversionStatus::INVALID_BITSTREAM;
+    try {
+      diagnostics->parserError = what ? what : "";
+    } catch (...) {
+      diagnostics->parserError.clear();
+    }
+  }
+  return EConversionStatus::INVALID_BITSTREAM;
+}
+
 struct SConfigurationInfo {
+  //! Set if the config walk was aborted, the remaining config is not parsed in that case
+  EConversionStatus status = EConversionStatus::OK;
   std::vector<SB_VIOLATIONS> sbViolations;
   bool fulfillsLevel3BaseLevelRestrictions = true;
   SProfileLevel profileLevel;
@@ -175,8 +223,43 @@ enum class HorizontalSpeakerDirection : uint8_t {
   BACK_CENTER = 180,  // 180°
 };
 
+//! Bit writer discarding all bits, used to walk a config without building the converted one.
+class CNullBitWriter {
+ public:
+  template <class T>
+  void write(T /*value*/, uint32_t /*numBits*/) {}
+  void byteAlign() {}
+};
+
+static void writeEscapedValue(ilo::CBitBuffer& writer, uint64_t value, uint32_t nBits1,
+                              uint32_t nBits2, uint32_t nBits3) {
+  mmt::mhasparserlib::writeEscapedValue(writer, value, nBits1, nBits2, nBits3);
+}
+
+static void writeEscapedValue(CNullBitWriter& /*writer*/, uint64_t /*value*/, uint32_t /*nBits1*/,
+                              uint32_t /*nBits2*/, uint32_t /*nBits3*/) {}
+
+//! Appends all bits written to @p bits to @p writer.
+static void appendBits(ilo::CBitBuffer& writer, ilo::CBitBuffer& bits) {
+  auto bitsBuffer = bits.bytebuffer();
+
+  ilo::CBitParser bitsReader(bitsBuffer, bits.nofBits());
+
+  while (bitsReader.nofBits() - bitsReader.tell() >= 8) {
+    writer.write(bitsReader.read<uint8_t>(8), 8);
+  }
+
+  auto numBitsLeft = bitsReader.nofBits() - bitsReader.tell();
+  if (numBitsLeft != 0) {
+    writer.write(bitsReader.read<uint8_t>(numBitsLeft), numBitsLeft);
+  }
+}
+
+static void appendBits(CNullBitWriter& /*writer*/, CNullBitWriter& /*bits*/) {}
+
+template <class Writer>
 static HorizontalSpeakerDirection copyMpegH3daSpeakerDescription(ilo::CBitParser& parser,
-                                                                 ilo::CBitBuffer& writer,
+                                                                 Writer& writer,
                                                                  bool angularPrecision) {
   HorizontalSpeakerDirection position = HorizontalSpeakerDirection::FRONT_CENTER;
 
@@ -250,7 +333,8 @@ static HorizontalSpeakerDirection copyMpegH3daSpeakerDescription(ilo::CBitParser
   return position;
 }
 
-static void copyMpegH3daFlexibleSpeakerConfig(ilo::CBitParser& parser, ilo::CBitBuffer& writer,
+template <class Writer>
+static void copyMpegH3daFlexibleSpeakerConfig(ilo::CBitParser& parser, Writer& writer,
                                               uint32_t numSpeakers) {
   uint8_t angularPrecision = parser.read<uint8_t>(1);
   writer.write(angularPrecision, 1);
@@ -269,7 +353,8 @@ static void copyMpegH3daFlexibleSpeakerConfig(ilo::CBitParser& parser, ilo::CBit
   }
 }
 
-static void copySpeakerConfig3d(ilo::CBitParser& parser, ilo::CBitBuffer& writer) {
+template <class Writer>
+static void copySpeakerConfig3d(ilo::CBitParser& parser, Writer& writer) {
   auto speakerLayoutType = parser.read<uint8_t>(2);
   writer.write(speakerLayoutType, 2);
   if (speakerLayoutType == 0)  // single ChannelConfiguration index
@@ -279,7 +364,7 @@ static void copySpeakerConfig3d(ilo::CBitParser& parser, ilo::CBitBuffer& writer
   } else {
     auto numSpeakersMinus1 =
         static_cast<uint32_t>(mmt::mhasparserlib::readEscapedValue(parser, 5, 8, 16));
-    mmt::mhasparserlib::writeEscapedValue(writer, numSpeakersMinus1, 5, 8, 16);
+    writeEscapedValue(writer, numSpeakersMinus1, 5, 8, 16);
     auto numSpeakers = numSpeakersMinus1 + 1;
     if (speakerLayoutType == 1)  // list of LoudspeakerGeometry indices
     {
@@ -302,7 +387,8 @@ static void pushViolation(std::vector<SB_VIOLATIONS>& vector, SB_VIOLATIONS viol
   }
 }
 
-static uint32_t copyFrameworkConfig3d(ilo::CBitParser& parser, ilo::CBitBuffer& writer,
+template <class Writer>
+static uint32_t copyFrameworkConfig3d(ilo::CBitParser& parser, Writer& writer,
                                       SConfigurationInfo& info) {
   uint32_t numAudioChannels = 0;
   uint32_t numAudioObjects = 0;
@@ -318,7 +404,7 @@ static uint32_t copyFrameworkConfig3d(ilo::CBitParser& parser, ilo::CBitBuffer&
 
     auto numberOfSignals =
         static_cast<uint32_t>(mmt::mhasparserlib::readEscapedValue(parser, 5, 8, 16));
-    mmt::mhasparserlib::writeEscapedValue(writer, numberOfSignals, 5, 8, 16);
+    writeEscapedValue(writer, numberOfSignals, 5, 8, 16);
 
     switch (signalType) {
       case SignalGroupType::Object:
@@ -365,7 +451,8 @@ static uint32_t copyFrameworkConfig3d(ilo::CBitParser& parser, ilo::CBitBuffer&
          1;
 }
 
-static bool copyMpegH3daCoreConfig(ilo::CBitParser& parser, ilo::CBitBuffer& writer,
+template <class Writer>
+static bool copyMpegH3daCoreConfig(ilo::CBitParser& parser, Writer& writer,
                                    SConfigurationInfo& info) {
   uint8_t twMdct = parser.read<uint8_t>(1);
   writer.write(twMdct, 1);
@@ -394,12 +481,14 @@ static bool copyMpegH3daCoreConfig(ilo::CBitParser& parser, ilo::CBitBuffer& wri
   return enhancedNoiseFilling == 1U;
 }
 
-static void copyMpegH3daSingleChannelElementConfig(ilo::CBitParser& parser, ilo::CBitBuffer& writer,
+template <class Writer>
+static void copyMpegH3daSingleChannelElementConfig(ilo::CBitParser& parser, Writer& writer,
                                                    SConfigurationInfo& info) {
   copyMpegH3daCoreConfig(parser, writer, info);
 }
 
-static void copyMpegh3daChannelPairElementConfig(ilo::CBitParser& parser, ilo::CBitBuffer& writer,
+template <class Writer>
+static void copyMpegh3daChannelPairElementConfig(ilo::CBitParser& parser, Writer& writer,
                                                  uint32_t numBits, SConfigurationInfo& info) {
   bool enf = copyMpegH3daCoreConfig(parser, writer, info);
   if (enf) {
@@ -410,8 +499,10 @@ static void copyMpegh3daChannelPairElementConfig(ilo::CBitParser& parser, ilo::C
   auto qceIndex = parser.read<uint8_t>(2);
   writer.write(qceIndex, 2);
   if (qceIndex != 0) {
+    // the remaining element config syntax depends on qceIndex, so the walk can't continue
     pushViolation(info.sbViolations, SB_VIOLATIONS::INVALID_QCE_INDEX);
-    ILO_FAIL(errorMessage(info.sbViolations).c_str());
+    info.status = EConversionStatus::NOT_BASELINE_COMPATIBLE;
+    return;
   }
 
   uint8_t shiftIndex1 = parser.read<uint8_t>(1);
@@ -425,27 +516,28 @@ static void copyMpegh3daChannelPairElementConfig(ilo::CBitParser& parser, ilo::C
   writer.write(lpdStereoEnabled, 1);
 }
 
-static void copyMpegh3daExtElementConfig(ilo::CBitParser& parser, ilo::CBitBuffer& writer,
-                                         bool isFirstFrame, SConfigurationInfo& info) {
+template <class Writer>
+static void copyMpegh3daExtElementConfig(ilo::CBitParser& parser, Writer& writer, bool isFirstFrame,
+                                         SConfigurationInfo& /* info */) {
   uint32_t usacExtElementType =
       static_cast<uint32_t>(mmt::mhasparserlib::readEscapedValue(parser, 4, 8, 16));
-  mmt::mhasparserlib::writeEscapedValue(writer, usacExtElementType, 4, 8, 16);
+  writeEscapedValue(writer, usacExtElementType, 4, 8, 16);
   if (!isFirstFrame) {
     if (usacExtElementType == ID_EXT_ELE_AUDIOPREROLL) {
-      ILO_LOG_WARNING("ID_EXT_ELE_AUDIOPREROLL is not the first ExtElementConfig.");
+      AU2MHAS_LOG_WARNING("ID_EXT_ELE_AUDIOPREROLL is not the first ExtElementConfig.");
     }
   }
 
   auto usacExtElementConfigLength =
       static_cast<uint32_t>(mmt::mhasparserlib::readEscapedValue(parser, 4, 8, 16));
-  mmt::mhasparserlib::writeEscapedValue(writer, usacExtElementConfigLength, 4, 8, 16);
+  writeEscapedValue(writer, usacExtElementConfigLength, 4, 8, 16);
 
   uint8_t usacExtElementDefaultLengthPresent = parser.read<uint8_t>(1);
   writer.write(usacExtElementDefaultLengthPresent, 1);
   if (usacExtElementDefaultLengthPresent) {
     auto usacExtElementDefaultLength =
         static_cast<uint32_t>(mmt::mhasparserlib::readEscapedValue(parser, 8, 16, 0));
-    mmt::mhasparserlib::writeEscapedValue(writer, usacExtElementDefaultLength, 8, 16, 0);
+    writeEscapedValue(writer, usacExtElementDefaultLength, 8, 16, 0);
   }
 
   auto usacExtElementPayloadFrag = parser.read<uint8_t>(1);
@@ -457,11 +549,12 @@ static void copyMpegh3daExtElementConfig(ilo::CBitParser& parser, ilo::CBitBuffe
   }
 }
 
-static void copyMpegH3daDecoderConfig(ilo::CBitParser& parser, ilo::CBitBuffer& writer,
-                                      uint32_t numBits, SConfigurationInfo& info) {
+template <class Writer>
+static void copyMpegH3daDecoderConfig(ilo::CBitParser& parser, Writer& writer, uint32_t numBits,
+                                      SConfigurationInfo& info) {
   uint32_t numElementsMinus1 =
       static_cast<uint32_t>(mmt::mhasparserlib::readEscapedValue(parser, 4, 8, 16));
-  mmt::mhasparserlib::writeEscapedValue(writer, numElementsMinus1, 4, 8, 16);
+  writeEscapedValue(writer, numElementsMinus1, 4, 8, 16);
 
   auto numElements = numElementsMinus1 + 1;
 
@@ -486,10 +579,15 @@ static void copyMpegH3daDecoderConfig(ilo::CBitParser& parser, ilo::CBitBuffer&
         copyMpegh3daExtElementConfig(parser, writer, (i == 0), info);
         break;
     }
+
+    if (info.status != EConversionStatus::OK) {
+      return;
+    }
   }
 }
 
-static void copyUntilConfigExtension(ilo::CBitParser& parser, ilo::CBitBuffer& writer,
+template <class Writer>
+static void copyUntilConfigExtension(ilo::CBitParser& parser, Writer& writer,
                                      SConfigurationInfo& info) {
   auto mpegh3daProfileLevelIndication = parser.read<uint8_t>(8);
   info.profileLevel.set(mpegh3daProfileLevelIndication);
@@ -505,7 +603,10 @@ static void copyUntilConfigExtension(ilo::CBitParser& parser, ilo::CBitBuffer& w
   auto coreSbrFrameLengthIndex = parser.read<uint8_t>(3);
   writer.write(coreSbrFrameLengthIndex, 3);
 
-  ILO_ASSERT(coreSbrFrameLengthIndex < 2, "Invalid LC config found.");
+  if (coreSbrFrameLengthIndex >= 2) {
+    info.status = EConversionStatus::INVALID_CORE_SBR_FRAME_LENGTH_INDEX;
+    return;
+  }
 
   auto flags = parser.read<uint8_t>(2);
   writer.write(flags, 2);
@@ -515,14 +616,15 @@ static void copyUntilConfigExtension(ilo::CBitParser& parser, ilo::CBitBuffer& w
   copyMpegH3daDecoderConfig(parser, writer, numBits, info);
 }
 
+template <class Writer>
 static void copyCompatibleProfileLevelSetMpegh3daConfigExtension(ilo::CBitParser& parser,
-                                                                 ilo::CBitBuffer& writer,
+                                                                 Writer& writer,
                                                                  SConfigurationInfo& info) {
-  mmt::mhasparserlib::writeEscapedValue(writer, ID_CONFIG_EXT_COMPATIBLE_PROFILELVL_SET, 4, 8, 16);
+  writeEscapedValue(writer, ID_CONFIG_EXT_COMPATIBLE_PROFILELVL_SET, 4, 8, 16);
 
   auto configExtLength =
       static_cast<uint32_t>(mmt::mhasparserlib::readEscapedValue(parser, 4, 8, 16));
-  mmt::mhasparserlib::writeEscapedValue(writer, configExtLength, 4, 8, 16);
+  writeEscapedValue(writer, configExtLength, 4, 8, 16);
 
   // copy CompatibleSetIndications
   for (uint32_t k = 0; k < configExtLength; k++) {
@@ -531,7 +633,7 @@ static void copyCompatibleProfileLevelSetMpegh3daConfigExtension(ilo::CBitParser
 
     if (k == configExtLength - 1) {
       // store last CompatibleSetIndication in configuration info
-      ILO_LOG_INFO(
+      AU2MHAS_LOG_INFO(
           "extractASIFromConfigExtensionAndAddCompatibleProfileLevelSet - CompatibleProfileLevel "
           "%u",
           value);
@@ -540,13 +642,14 @@ static void copyCompatibleProfileLevelSetMpegh3daConfigExtension(ilo::CBitParser
   }
 }
 
-static void copyGenericMpegh3daConfigExtension(ilo::CBitParser& parser, ilo::CBitBuffer& writer,
+template <class Writer>
+static void copyGenericMpegh3daConfigExtension(ilo::CBitParser& parser, Writer& writer,
                                                uint32_t configExtType) {
-  mmt::mhasparserlib::writeEscapedValue(writer, configExtType, 4, 8, 16);
+  writeEscapedValue(writer, configExtType, 4, 8, 16);
 
   auto configExtLength =
       static_cast<uint32_t>(mmt::mhasparserlib::readEscapedValue(parser, 4, 8, 16));
-  mmt::mhasparserlib::writeEscapedValue(writer, configExtLength, 4, 8, 16);
+  writeEscapedValue(writer, configExtLength, 4, 8, 16);
 
   // copy extension body
   for (uint32_t k = 0; k < configExtLength; k++) {
@@ -555,14 +658,15 @@ static void copyGenericMpegh3daConfigExtension(ilo::CBitParser& parser, ilo::CBi
   }
 }
 
-static void writeCompatibleProfileLevelSetToConfig(ilo::CBitBuffer& writer,
-                                                   SConfigurationInfo& info) {
-  ILO_ASSERT(info.profileLevel.get() >= ProfileLevels::LOW_COMPLEXITY_LEVEL_1 &&
-                 info.profileLevel.get() <= ProfileLevels::LOW_COMPLEXITY_LEVEL_5,
-             "Only LC bitstreams are supported, found profile level: %d",
-             static_cast<int>(info.profileLevel.get()));
-  mmt::mhasparserlib::writeEscapedValue(writer, 7, 4, 8, 16);  // usacConfigExtType = 7
-  mmt::mhasparserlib::writeEscapedValue(writer, 2, 4, 8, 16);  // usacConfigExtLength = 2
+template <class Writer>
+static void writeCompatibleProfileLevelSetToConfig(Writer& writer, SConfigurationInfo& info) {
+  if (info.profileLevel.get() < ProfileLevels::LOW_COMPLEXITY_LEVEL_1 ||
+      info.profileLevel.get() > ProfileLevels::LOW_COMPLEXITY_LEVEL_5) {
+    info.status = EConversionStatus::UNSUPPORTED_PROFILE_LEVEL;
+    return;
+  }
+  writeEscapedValue(writer, 7, 4, 8, 16);  // usacConfigExtType = 7
+  writeEscapedValue(writer, 2, 4, 8, 16);  // usacConfigExtLength = 2
   writer.write(0U, 4);  // bsNumCompatibleSets (num compatible profile sets - 1)
   writer.write(0U, 4);  // reserved
   uint8_t compatibleSetIndication = 0;
@@ -576,13 +680,14 @@ static void writeCompatibleProfileLevelSetToConfig(ilo::CBitBuffer& writer,
   }
   info.compatibleProfileLevel.set(compatibleSetIndication);
 
-  ILO_LOG_INFO("writeCompatibleProfileLevelSetToConfig - CompatibleProfileLevel %u",
+  AU2MHAS_LOG_INFO("writeCompatibleProfileLevelSetToConfig - CompatibleProfileLevel %u",
                static_cast<unsigned>(compatibleSetIndication));
   writer.write(compatibleSetIndication, 8);
 }
 
+template <class Writer>
 static ilo::ByteBuffer extractASIFromConfigExtensionAndAddCompatibleProfileLevelSet(
-    ilo::CBitParser& parser, ilo::CBitBuffer& writer, SConfigurationInfo& info) {
+    ilo::CBitParser& parser, Writer& writer, SConfigurationInfo& info) {
   ilo::ByteBuffer returnValue;
 
   bool hasExtensions = parser.read<uint8_t>(1) == 1;
@@ -593,7 +698,7 @@ static ilo::ByteBuffer extractASIFromConfigExtensionAndAddCompatibleProfileLevel
         static_cast<uint32_t>(mmt::mhasparserlib::readEscapedValue(parser, 2, 4, 8) + 1);
   }
 
-  ilo::CBitBuffer configExtensionsTempWriter;
+  Writer configExtensionsTempWriter;
   uint32_t numConfigExtensionsCopied = 0;
   bool compatibleProfileLevelSetFound = false;
 
@@ -608,7 +713,7 @@ static ilo::ByteBuffer extractASIFromConfigExtensionAndAddCompatibleProfileLevel
 
       std::generate_n(returnValue.begin(), length, [&parser] { return parser.read<uint8_t>(8); });
     } else if (configExtType == ID_CONFIG_EXT_COMPATIBLE_PROFILELVL_SET) {
-      ILO_LOG_INFO("Found ID_CONFIG_EXT_COMPATIBLE_PROFILELVL_SET, will not be overwritten.");
+      AU2MHAS_LOG_INFO("Found ID_CONFIG_EXT_COMPATIBLE_PROFILELVL_SET, will not be overwritten.");
       compatibleProfileLevelSetFound = true;
       copyCompatibleProfileLevelSetMpegh3daConfigExtension(parser, configExtensionsTempWriter,
                                                            info);
@@ -622,28 +727,18 @@ static ilo::ByteBuffer extractASIFromConfigExtensionAndAddCompatibleProfileLevel
   if (!compatibleProfileLevelSetFound &&
       info.profileLevel.get() < ProfileLevels::BASELINE_LEVEL_1) {
     writeCompatibleProfileLevelSetToConfig(configExtensionsTempWriter, info);
+    if (info.status != EConversionStatus::OK) {
+      return returnValue;
+    }
     numConfigExtensionsCopied++;
   } else {
-    ILO_LOG_WARNING("Skipping CompatibleSetIndication (extension already present)");
+    AU2MHAS_LOG_WARNING("Skipping CompatibleSetIndication (extension already present)");
   }
 
   if (numConfigExtensionsCopied != 0) {
     writer.write(1u, 1);
-    mmt::mhasparserlib::writeEscapedValue(writer, numConfigExtensionsCopied - 1, 2, 4, 8);
-
-    auto configExtensionsBuffer = configExtensionsTempWriter.bytebuffer();
-
-    ilo::CBitParser configExtensionsTempReader(configExtensionsBuffer,
-                                               configExtensionsTempWriter.nofBits());
-
-    while (configExtensionsTempReader.nofBits() - configExtensionsTempReader.tell() >= 8) {
-      writer.write(configExtensionsTempReader.read<uint8_t>(8), 8);
-    }
-
-    auto numBitsLeft = configExtensionsTempReader.nofBits() - configExtensionsTempReader.tell();
-    if (numBitsLeft != 0) {
-      writer.write(configExtensionsTempReader.read<uint8_t>(numBitsLeft), numBitsLeft);
-    }
+    writeEscapedValue(writer, numConfigExtensionsCopied - 1, 2, 4, 8);
+    appendBits(writer, configExtensionsTempWriter);
   } else {
     writer.write(0u, 1);
   }
@@ -654,7 +749,7 @@ static ilo::ByteBuffer extractASIFromConfigExtensionAndAddCompatibleProfileLevel
 
 uint8_t SProfileLevel::get() const noexcept {
   if (!m_profileLevelSet) {
-    ILO_LOG_WARNING(
+    AU2MHAS_LOG_WARNING(
         "Retrieving Profile Level that was not set, perhaps no decoder config record was found in "
         "the input file, returning %d as a sensible default",
         static_cast<int>(ProfileLevels::LOW_COMPLEXITY_LEVEL_3));
@@ -670,14 +765,110 @@ CConverter::CConverter(const CConverter::SConverterConfiguration& config)
   ILO_ASSERT(m_currentPacketLabel != 0, "Provided packet label is zero.");
 }
 
+static EConversionStatus reportConfigFailure(SConversionDiagnostics* diagnostics,
+                                             SConfigurationInfo& info) {
+  EConversionStatus status = info.status != EConversionStatus::OK
+                                 ? info.status
+                                 : EConversionStatus::NOT_BASELINE_COMPATIBLE;
+  if (diagnostics) {
+    diagnostics->status = status;
+    diagnostics->violations = std::move(info.sbViolations);
+    diagnostics->profileLevel = info.profileLevel.get();
+  }
+  return status;
+}
+
 SMhasConfigOutput CConverter::convertConfig(const ilo::ByteBuffer& mpegh3daConfig) {
+  SMhasConfigOutput out;
+  SConversionDiagnostics diagnostics;
+  if (convertConfigChecked(mpegh3daConfig, out, &diagnostics) != EConversionStatus::OK) {
+    ILO_FAIL(diagnostics.message().c_str());
+  }
+  return out;
+}
+
+EConversionStatus CConverter::tryConvertConfig(const ilo::ByteBuffer& mpegh3daConfig,
+                                               SMhasConfigOutput& output,
+                                               SConversionDiagnostics* diagnostics) noexcept {
+  resetDiagnostics(diagnostics);
+  try {
+    return convertConfigChecked(mpegh3daConfig, output, diagnostics);
+  } catch (const std::exception& e) {
+    return reportParserError(diagnostics, e.what());
+  } catch (...) {
+    return reportParserError(diagnostics, nullptr);
+  }
+}
+
+static void setParserError(SConfigValidation& result, const char* what) noexcept {
+  result.status = EConversionStatus::INVALID_BITSTREAM;
+  try {
+    result.parserError = what ? what : "";
+  } catch (...) {
+    result.parserError.clear();
+  }
+}
+
+EConversionStatus CConverter::validateConfig(const ilo::ByteBuffer& mpegh3daConfig,
+                                             SConfigValidation& result) noexcept {
+  // keep the allocated buffers of the previous validation
+  result.status = EConversionStatus::OK;
+  result.violations.clear();
+  result.profileLevel = SProfileLevel();
+  result.compatibleProfileLevel = SProfileLevel();
+  result.hasAsi = false;
+  result.parserError.clear();
+
+  try {
+    SConfigurationInfo info;
+    ilo::CBitParser configParser(mpegh3daConfig);
+    CNullBitWriter configWriter;
+    copyUntilConfigExtension(configParser, configWriter, info);
+    if (info.status == EConversionStatus::OK) {
+      auto asi = extractASIFromConfigExtensionAndAddCompatibleProfileLevelSet(configParser,
+                                                                              configWriter, info);
+      result.hasAsi = !asi.empty();
+    }
+
+    if (info.status != EConversionStatus::OK) {
+      result.status = info.status;
+    } else if (!info.sbViolations.empty()) {
+      result.status = EConversionStatus::NOT_BASELINE_COMPATIBLE;
+    } else {
+      result.compatibleProfileLevel = info.compatibleProfileLevel;
+    }
+    result.violations = std::move(info.sbViolations);
+    result.profileLevel = info.profileLevel;
+  } catch (const std::exception& e) {
+    setParserError(result, e.what());
+  } catch (...) {
+    setParserError(result, nullptr);
+  }
+  return result.status;
+}
+
+EConversionStatus CConverter::convertConfigChecked(const ilo::ByteBuffer& mpegh3daConfig,
+                                                   SMhasConfigOutput& out,
+                                                   SConversionDiagnostics* diagnostics) {
+  if (mpegh3daConfig.empty()) {
+    return reportParserError(diagnostics, "Config does not contain any payload");
+  }
+
+  CStopwatch stopwatch;
   SConfigurationInfo info;
   ilo::CBitParser configParser(mpegh3daConfig);
   ilo::CBitBuffer configWriter;
   copyUntilConfigExtension(configParser, configWriter, info);
+  if (info.status != EConversionStatus::OK) {
+    return reportConfigFailure(diagnostics, info);
+  }
 
   auto asi = extractASIFromConfigExtensionAndAddCompatibleProfileLevelSet(configParser,
                                                                           configWriter, info);
+  // note: the violations are only reported after the walk to collect all of them
+  if (info.status != EConversionStatus::OK || !info.sbViolations.empty()) {
+    return reportConfigFailure(diagnostics, info);
+  }
   bool hasAsi = !asi.empty();
 
   ilo::ByteBuffer convertedConfig = configWriter.bytebuffer();
@@ -693,19 +884,21 @@ SMhasConfigOutput CConverter::convertConfig(const ilo::ByteBuffer& mpegh3daConfi
     asiPacket.writePacket(asiBuffer);
   }
 
-  ILO_ASSERT(info.sbViolations.empty(), errorMessage(info.sbViolations).c_str());
-
   ilo::ByteBuffer configBuffer(configPacket.calculatePacketSize());
   configPacket.writePacket(configBuffer);
 
   if (m_currentConfig &&
       (*m_currentConfig != configBuffer || (m_currentAsi && !hasAsi) || (!m_currentAsi && hasAsi) ||
        (m_currentAsi && hasAsi && *m_currentAsi != asiBuffer))) {
+    const uint32_t previousPacketLabel = m_currentPacketLabel;
     ++m_currentPacketLabel;
     m_currentPacketLabel %= (MAX_PACKET_LABEL_MAIN_STREAM + 1);
     if (m_currentPacketLabel == 0) {
       m_currentPacketLabel = 1;
     }
+    ++m_statistics.packetLabelRotations;
+    AU2MHAS_PROBE3(config__change, previousPacketLabel, m_currentPacketLabel,
+                   static_cast<uint64_t>(mpegh3daConfig.size()));
 
     configPacket = mmt::mhasparserlib::CMhasConfigPacket(
         m_currentPacketLabel, convertedConfig.begin(), convertedConfig.end());
@@ -730,20 +923,26 @@ SMhasConfigOutput CConverter::convertConfig(const ilo::ByteBuffer& mpegh3daConfi
       m_currentAsi = ilo::make_unique<ilo::ByteBuffer>(asiBuffer);
     }
   }
+  m_currentConfigInput.assign(mpegh3daConfig.begin(), mpegh3daConfig.end());
 
-  SMhasConfigOutput out;
   out.fullMpegHConfigBlob = convertedConfig;
   out.config = std::move(configBuffer);
+  out.compatibleProfileLevel = SProfileLevel();
   out.compatibleProfileLevel.set(info.compatibleProfileLevel.get());
   if (hasAsi) {
     out.asi = ilo::make_unique<ilo::ByteBuffer>(asiBuffer);
+  } else {
+    out.asi.reset();
   }
-  return out;
-}
 
-static bool isIpf(const ilo::ByteBuffer& mpegh3daFrame) {
-  ILO_ASSERT(!mpegh3daFrame.empty(), "Frame does not contain any payload");
-  return (mpegh3daFrame[0] & 0xE0u) == 0xC0u;
+  ++m_statistics.configConversions;
+  m_statistics.bytesIn += mpegh3daConfig.size();
+  m_statistics.bytesOut += out.config.size() + (hasAsi ? out.asi->size() : 0);
+  // the config is walked bit by bit, the MHAS packets are written from the resulting blobs
+  m_statistics.bitwiseCopyBytes += mpegh3daConfig.size();
+  m_statistics.bulkCopyBytes += convertedConfig.size() + (hasAsi ? asi.size() : 0);
+  m_statistics.convertConfigNs += stopwatch.elapsedNs();
+  return EConversionStatus::OK;
 }
 
 static bool isIFrame(const ilo::ByteBuffer& mpegh3daFrame) {
@@ -751,6 +950,56 @@ static bool isIFrame(const ilo::ByteBuffer& mpegh3daFrame) {
   return (mpegh3daFrame[0] & 0x80u) == 0x80u;
 }
 
+static constexpr uint32_t PACTYP_MPEGH3DAFRAME = 2;
+//! Upper bound of the MHAS packet header size: escapedValue(3,8,8), (2,8,32) and (11,24,24)
+static constexpr size_t MAX_MHAS_HEADER_BYTES = 15;
+
+static void writeBits(uint8_t* buffer, uint32_t& bitPosition, uint64_t value, uint32_t numBits) {
+  for (uint32_t i = numBits; i > 0; --i) {
+    const uint32_t bit = static_cast<uint32_t>((value >> (i - 1)) & 1u);
+    buffer[bitPosition / 8] |= static_cast<uint8_t>(bit << (7 - bitPosition % 8));
+    ++bitPosition;
+  }
+}
+
+//! Same encoding as mmt::mhasparserlib::writeEscapedValue, but into a fixed-size array
+static void writeEscapedBits(uint8_t* buffer, uint32_t& bitPosition, uint64_t value,
+                             uint32_t numBits1, uint32_t numBits2, uint32_t numBits3) {
+  const uint64_t escape1 = (uint64_t{1} << numBits1) - 1;
+  if (value < escape1) {
+    writeBits(buffer, bitPosition, value, numBits1);
+    return;
+  }
+  writeBits(buffer, bitPosition, escape1, numBits1);
+  value -= escape1;
+
+  const uint64_t escape2 = (uint64_t{1} << numBits2) - 1;
+  if (value < escape2) {
+    writeBits(buffer, bitPosition, value, numBits2);
+    return;
+  }
+  writeBits(buffer, bitPosition, escape2, numBits2);
+  writeBits(buffer, bitPosition, value - escape2, numBits3);
+}
+
+/*!
+ * Writes the MHAS frame packet of a regular frame into @p packet, reusing its capacity.
+ * The header of a frame packet always ends on a byte boundary.
+ */
+static void writeFramePacket(const ilo::ByteBuffer& mpegh3daFrame, uint32_t packetLabel,
+                             ilo::ByteBuffer& packet) {
+  uint8_t header[MAX_MHAS_HEADER_BYTES] = {};
+  uint32_t headerBits = 0;
+  writeEscapedBits(header, headerBits, PACTYP_MPEGH3DAFRAME, 3, 8, 8);
+  writeEscapedBits(header, headerBits, packetLabel, 2, 8, 32);
+  writeEscapedBits(header, headerBits, mpegh3daFrame.size(), 11, 24, 24);
+  const size_t headerBytes = headerBits / 8;
+
+  packet.resize(headerBytes + mpegh3daFrame.size());
+  std::memcpy(packet.data(), header, headerBytes);
+  std::memcpy(packet.data() + headerBytes, mpegh3daFrame.data(), mpegh3daFrame.size());
+}
+
 static SMhasFrameOutput convertFrameInternal(const ilo::ByteBuffer& mpegh3daFrame, bool isIPF,
                                              uint32_t currentPacketLabel) {
   auto begin = mpegh3daFrame.cbegin();
@@ -765,22 +1014,80 @@ static SMhasFrameOutput convertFrameInternal(const ilo::ByteBuffer& mpegh3daFram
 }
 
 SMhasFrameOutput CConverter::convertFrame(const ilo::ByteBuffer& mpegh3daFrame) {
-  bool inputIpf = isIpf(mpegh3daFrame);
-  auto out = inputIpf ? convertIPF(mpegh3daFrame)
-                      : convertFrameInternal(mpegh3daFrame, false, m_currentPacketLabel);
+  SMhasFrameOutput out;
+  convertFrame(mpegh3daFrame, out);
+  return out;
+}
+
+void CConverter::convertFrame(const ilo::ByteBuffer& mpegh3daFrame, SMhasFrameOutput& output) {
+  SConversionDiagnostics diagnostics;
+  if (convertFrameChecked(mpegh3daFrame, output, &diagnostics) != EConversionStatus::OK) {
+    ILO_FAIL(diagnostics.message().c_str());
+  }
+}
+
+bool CConverter::isCurrentConfig(const ilo::ByteBuffer& mpegh3daConfig) const {
+  return m_currentConfig && m_currentConfigInput == mpegh3daConfig;
+}
+
+EConversionStatus CConverter::tryConvertFrame(const ilo::ByteBuffer& mpegh3daFrame,
+                                              SMhasFrameOutput& output,
+                                              SConversionDiagnostics* diagnostics) noexcept {
+  resetDiagnostics(diagnostics);
+  try {
+    return convertFrameChecked(mpegh3daFrame, output, diagnostics);
+  } catch (const std::exception& e) {
+    return reportParserError(diagnostics, e.what());
+  } catch (...) {
+    return reportParserError(diagnostics, nullptr);
+  }
+}
+
+EConversionStatus CConverter::convertFrameChecked(const ilo::ByteBuffer& mpegh3daFrame,
+                                                  SMhasFrameOutput& out,
+                                                  SConversionDiagnostics* diagnostics) {
+  if (mpegh3daFrame.empty()) {
+    return reportFailure(diagnostics, EConversionStatus::EMPTY_FRAME);
+  }
+
+  CStopwatch stopwatch;
+  const uint64_t convertConfigNs = m_statistics.convertConfigNs;
+  ILO_ASSERT(!mpegh3daFrame.empty(), "Frame does not contain any payload");
+  bool inputIpf = startsWithAudioPreRoll(mpegh3daFrame);
+  if (inputIpf) {
+    // note: checked up front, so a truncated IPF doesn't unwind out of the bit parser
+    if (!audioPreRollFitsInFrame(mpegh3daFrame)) {
+      return reportParserError(diagnostics, "AudioPreRoll exceeds the frame");
+    }
+    EConversionStatus status = convertIPF(mpegh3daFrame, out, diagnostics);
+    if (status != EConversionStatus::OK) {
+      return status;
+    }
+  } else {
+    // note: keeps the capacity of the output buffers, so steady state needs no heap allocation
+    writeFramePacket(mpegh3daFrame, m_currentPacketLabel, out.frame);
+    out.config.reset();
+    out.asi.reset();
+  }
   out.isIpf = inputIpf;
   out.isIndepFrame = inputIpf || isIFrame(mpegh3daFrame);
   ++m_currentFrameNumber;
-  return out;
-}
 
-static uint32_t readExtElementPayloadLength(ilo::CBitParser& parser) {
-  auto value = parser.read<uint32_t>(8);
-  if (value == 255) {
-    auto tmpValue = parser.read<uint16_t>(16);
-    value += tmpValue - 2;
+  ++m_statistics.frames;
+  m_statistics.bytesIn += mpegh3daFrame.size();
+  m_statistics.bytesOut += out.frame.size();
+  if (inputIpf) {
+    // IPFs are rewritten bit by bit to strip the embedded config
+    ++m_statistics.ipfs;
+    m_statistics.bitwiseCopyBytes += mpegh3daFrame.size();
+    // the embedded config is already accounted in convertConfigNs
+    m_statistics.convertIpfNs +=
+        stopwatch.elapsedNs() - (m_statistics.convertConfigNs - convertConfigNs);
+  } else {
+    m_statistics.bulkCopyBytes += mpegh3daFrame.size();
+    m_statistics.convertFrameNs += stopwatch.elapsedNs();
   }
-  return value;
+  return EConversionStatus::OK;
 }
 
 static void writeExtElementPayloadLength(ilo::CBitBuffer& buffer, uint32_t value) {
@@ -798,31 +1105,33 @@ uint32_t CConverter::currentPacketLabel() const {
   return m_currentPacketLabel;
 }
 
-SMhasFrameOutput CConverter::convertIPF(const ilo::ByteBuffer& mpegh3daFrame) {
+EConversionStatus CConverter::convertIPF(const ilo::ByteBuffer& mpegh3daFrame,
+                                         SMhasFrameOutput& output,
+                                         SConversionDiagnostics* diagnostics) {
+  AU2MHAS_PROBE2(ipf, m_currentFrameNumber, static_cast<uint64_t>(mpegh3daFrame.size()));
   ilo::CBitParser parser(mpegh3daFrame);
   ilo::CBitBuffer writer;
 
-  uint8_t value = parser.read<uint8_t>(3);
-  ILO_ASSERT(value == 6, "Frame does not contain any AudioPreRoll.");
-  writer.write(value, 3);
+  SAudioPreRollHeader preRoll;
+  if (!readAudioPreRollHeader(parser, preRoll)) {
+    return reportFailure(diagnostics, EConversionStatus::MISSING_AUDIO_PREROLL);
+  }
+  writer.write(6u, 3);
 
-  uint32_t extensionPayloadLength = readExtElementPayloadLength(parser);
-  uint32_t positionBegin = parser.tell();
+  uint32_t extensionPayloadLength = preRoll.payloadLength;
+  uint32_t positionBegin = preRoll.payloadBegin;
 
   ilo::CBitBuffer temp;
   SMhasConfigOutput mhasConfig;
-  uint32_t configLength =
-      static_cast<uint32_t>(mmt::mhasparserlib::readEscapedValue(parser, 4, 4, 8));
-  if (configLength != 0) {
-    ilo::ByteBuffer config(configLength);
-
-    for (uint32_t i = 0; i < configLength; ++i) {
-      auto mpegh3daConfigByte = parser.read<uint8_t>(8);
-      config[i] = mpegh3daConfigByte;
+  if (!preRoll.config.empty()) {
+    EConversionStatus status = convertConfigChecked(preRoll.config, mhasConfig, diagnostics);
+    if (status != EConversionStatus::OK) {
+      return status;
     }
-    mhasConfig = convertConfig(config);
   } else {
-    ILO_ASSERT(m_currentConfig, "No AudioPreRoll config found and no config available.");
+    if (!m_currentConfig) {
+      return reportFailure(diagnostics, EConversionStatus::MISSING_CONFIG);
+    }
     if (m_currentAsi) {
       mhasConfig.asi = ilo::make_unique<ilo::ByteBuffer>(*m_currentAsi);
     }
@@ -840,17 +1149,16 @@ SMhasFrameOutput CConverter::convertIPF(const ilo::ByteBuffer& mpegh3daFrame) {
   auto numPrerollFrames = mmt::mhasparserlib::readEscapedValue(parser, 2, 4, 0);
   mmt::mhasparserlib::writeEscapedValue(temp, numPrerollFrames, 2, 4, 0);
 
-  ILO_LOG_INFO("Sample %" PRIu64 " is an IPF. ", m_currentFrameNumber);
-  ILO_LOG_INFO("numPreRollFrames %" PRIu64 ", ", numPrerollFrames);
-  ILO_LOG_INFO("applyCrossfade %u", applyCrossfade);
+  AU2MHAS_LOG_INFO("Sample %" PRIu64 " is an IPF. numPreRollFrames %" PRIu64 ", applyCrossfade %u",
+                   m_currentFrameNumber, numPrerollFrames, applyCrossfade);
 
   if (!applyCrossfade || numPrerollFrames == 0) {
-    ILO_LOG_WARNING("This can lead to audible artifacts during bitrate adaptation.");
+    AU2MHAS_LOG_WARNING("This can lead to audible artifacts during bitrate adaptation.");
   }
 
   if (numPrerollFrames > 1) {
-    ILO_LOG_WARNING("numPreRollFrames is: %u. Maximal one pre-roll frame is allowed.",
-                    numPrerollFrames);
+    AU2MHAS_LOG_WARNING("numPreRollFrames is: %" PRIu64 ". Maximal one pre-roll frame is allowed.",
+                        numPrerollFrames);
   }
 
   for (uint64_t i = 0; i < numPrerollFrames; ++i) {
@@ -860,7 +1168,7 @@ SMhasFrameOutput CConverter::convertIPF(const ilo::ByteBuffer& mpegh3daFrame) {
       auto frameByte = parser.read<uint8_t>(8);
       if (i == 0 && k == 0) {
         if ((frameByte & 0x80u) != 0x80u) {
-          ILO_LOG_WARNING(
+          AU2MHAS_LOG_WARNING(
               "Pre-roll frame is not independently decodable. If bitrate adaption is used, this "
               "can lead to audible artifacts.");
         }
@@ -869,8 +1177,9 @@ SMhasFrameOutput CConverter::convertIPF(const ilo::ByteBuffer& mpegh3daFrame) {
     }
   }
 
-  ILO_ASSERT(parser.tell() <= positionBegin + extensionPayloadLength * 8,
-             "Invalid extension segment payload length detected.");
+  if (parser.tell() > positionBegin + extensionPayloadLength * 8) {
+    return reportFailure(diagnostics, EConversionStatus::INVALID_PAYLOAD_LENGTH);
+  }
   parser.seek(static_cast<int32_t>(positionBegin + extensionPayloadLength * 8u),
               ilo::EPosType::begin);
 
@@ -896,11 +1205,12 @@ SMhasFrameOutput CConverter::convertIPF(const ilo::ByteBuffer& mpegh3daFrame) {
 
   auto byteBuffer = writer.bytebuffer();
   ilo::ByteBuffer frame(byteBuffer.begin(), byteBuffer.end());
-  auto returnValue = convertFrameInternal(frame, true, m_currentPacketLabel);
-  returnValue.config = ilo::make_unique<ilo::ByteBuffer>(mhasConfig.config);
-  returnValue.asi.swap(mhasConfig.asi);
+  output = convertFrameInternal(frame, true, m_currentPacketLabel);
+  m_statistics.bulkCopyBytes += frame.size();
+  output.config = ilo::make_unique<ilo::ByteBuffer>(mhasConfig.config);
+  output.asi.swap(mhasConfig.asi);
 
-  return returnValue;
+  return EConversionStatus::OK;
 }
 
 void logging::redirectToConsole() {
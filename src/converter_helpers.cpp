@@ -147,11 +147,11 @@ void openWriter(const CFileConverter::SConfig& config,
     trackConfig.configRecord = std::move(mhaDcr);
 
     if (config.copyMhap) {
-      ILO_LOG_INFO("Transfering profileAndLevelCompatibleSet from bitstream: %u",
+      AU2MHAS_LOG_INFO("Transfering profileAndLevelCompatibleSet from bitstream: %u",
                    static_cast<uint32_t>(profileLevel));
       trackConfig.profileAndLevelCompatibleSets = std::vector<uint8_t>({profileLevel});
     } else {
-      ILO_LOG_WARNING("Copy profileAndLevelCompatibleSets is disabled");
+      AU2MHAS_LOG_WARNING("Copy profileAndLevelCompatibleSets is disabled");
     }
 
     trackWriter = writer->trackWriter<mmt::isobmff::CMpeghTrackWriter>(trackConfig);
@@ -89,6 +89,7 @@ amm-info@iis.fraunhofer.de
 
 // Internal includes
 #include "converter_mha.h"
+#include "event_helpers.h"
 #include "file_converter_pimpl.h"
 #include "logging.h"
 
@@ -106,17 +107,20 @@ static void appendSyncPacket(ilo::ByteBuffer& sample) {
   sample.insert(sample.end(), mhasSyncPacket.begin(), mhasSyncPacket.end());
 }
 
-mmt::isobmff::CSample convertMhaSampleToMhm(const CFileConverter::SConfig& config,
-                                            CConverter& mhaConverter,
-                                            const mmt::isobmff::CSample& inSample,
-                                            const ilo::ByteBuffer& mpeghConfigFromMp4,
-                                            bool firstSample) {
-  mmt::isobmff::CSample outSample;
-
-  // note: required every iteration due to alternating packet labels
-  SMhasConfigOutput fileConfig = mhaConverter.convertConfig(mpeghConfigFromMp4);
+void convertMhaSampleToMhm(const CFileConverter::SConfig& config, CConverter& mhaConverter,
+                           const mmt::isobmff::CSample& inSample,
+                           const ilo::ByteBuffer& mpeghConfigFromMp4, uint64_t sampleIndex,
+                           SMhasFrameOutput& frame, mmt::isobmff::CSample& outSample) {
+  const bool firstSample = sampleIndex == 0;
+
+  // note: required every iteration due to alternating packet labels, but a config that is
+  // already the current one wouldn't change anything
+  SMhasConfigOutput fileConfig;
+  if (firstSample || !mhaConverter.isCurrentConfig(mpeghConfigFromMp4)) {
+    fileConfig = mhaConverter.convertConfig(mpeghConfigFromMp4);
+  }
 
-  SMhasFrameOutput frame = mhaConverter.convertFrame(inSample.rawData);
+  mhaConverter.convertFrame(inSample.rawData, frame);
   outSample.isSyncSample = frame.config != nullptr;
 
   if (firstSample && !outSample.isSyncSample) {
@@ -128,24 +132,27 @@ mmt::isobmff::CSample convertMhaSampleToMhm(const CFileConverter::SConfig& confi
     frame.asi = std::move(fileConfig.asi);
 
     if (!frame.isIpf) {
-      config.logCallback(
-          "First sample is not an IPF, playback will may not be possible until the first IPF has "
-          "been received.");
+      emitEvent(config, EEventCode::FIRST_SAMPLE_NOT_IPF, sampleIndex, inSample.rawData.size());
     }
   }
 
-  ilo::ByteBuffer mhmSample;
+  // note: the sample buffer is reused across samples
+  ilo::ByteBuffer& mhmSample = outSample.rawData;
+  mhmSample.clear();
 
   if (config.insertSyncBeforeEveryFrame) {
-    config.logCallback("Inserting Sync before every Frame");
+    emitEvent(config, EEventCode::SYNC_INSERTED, sampleIndex,
+              static_cast<uint64_t>(ESyncReason::EVERY_FRAME));
     appendSyncPacket(mhmSample);
   } else {
     if (config.insertSyncBeforeFirstFrame && firstSample) {
-      config.logCallback("Inserting Sync before first Frame");
+      emitEvent(config, EEventCode::SYNC_INSERTED, sampleIndex,
+                static_cast<uint64_t>(ESyncReason::FIRST_FRAME));
       appendSyncPacket(mhmSample);
     } else {
       if (config.insertSyncBeforeEveryIpf && frame.isIpf) {
-        config.logCallback("Inserting Sync before IPF");
+        emitEvent(config, EEventCode::SYNC_INSERTED, sampleIndex,
+                  static_cast<uint64_t>(ESyncReason::IPF));
         appendSyncPacket(mhmSample);
       }
     }
@@ -161,16 +168,14 @@ mmt::isobmff::CSample convertMhaSampleToMhm(const CFileConverter::SConfig& confi
   mhmSample.insert(mhmSample.end(), frame.frame.begin(), frame.frame.end());
   outSample.ctsOffset = inSample.ctsOffset;
   outSample.duration = inSample.duration;
-  outSample.rawData = mhmSample;
 
+  outSample.sampleGroupInfo = mmt::isobmff::SSampleGroupInfo();
   if (!frame.isIpf && frame.isIndepFrame) {
     // Signal as ISO/IEC 14496-12 AudioPreRollEntry in accordance with ISO/IEC 23008-3
     // subclause 20.2
     outSample.sampleGroupInfo =
         mmt::isobmff::SSampleGroupInfo(mmt::isobmff::SampleGroupType::prol, 1, 0);
   }
-
-  return outSample;
 }
 }  // namespace au2mhasconverterlib
 }  // namespace mmt
@@ -97,10 +97,15 @@ namespace mmt {
 namespace au2mhasconverterlib {
 std::unique_ptr<CConverter> openMhaConverter(uint32_t packetLabel);
 
-mmt::isobmff::CSample convertMhaSampleToMhm(const CFileConverter::SConfig& config,
-                                            CConverter& mhaConverter,
-                                            const mmt::isobmff::CSample& inSample,
-                                            const ilo::ByteBuffer& mpeghConfigFromMp4,
-                                            bool firstSample);
+/*!
+ * Converts the MHA sample @p inSample into @p outSample.
+ *
+ * @p frame is scratch space. Passing the same @p frame and @p outSample for all samples of a track
+ * reuses their buffers, so regular (non-IPF) samples don't allocate in steady state.
+ */
+void convertMhaSampleToMhm(const CFileConverter::SConfig& config, CConverter& mhaConverter,
+                           const mmt::isobmff::CSample& inSample,
+                           const ilo::ByteBuffer& mpeghConfigFromMp4, uint64_t sampleIndex,
+                           SMhasFrameOutput& frame, mmt::isobmff::CSample& outSample);
 }  // namespace au2mhasconverterlib
 }  // namespace mmt
@@ -81,7 +81,9 @@ amm-info@iis.fraunhofer.de
 -----------------------------------------------------------------------------*/
 
 // System includes
+#include <algorithm>
 #include <string>
+#include <vector>
 
 // External includes
 #include "ilo/memory.h"
@@ -92,6 +94,8 @@ amm-info@iis.fraunhofer.de
 
 // Internal includes
 #include "converter_mhm.h"
+#include "event_helpers.h"
+#include "file_io.h"
 #include "logging.h"
 
 namespace mmt {
@@ -102,45 +106,436 @@ std::unique_ptr<CConverter> openMhmConverter(uint32_t packetLabel) {
   return ilo::make_unique<CConverter>(converterConfig);
 }
 
-mmt::isobmff::CSample cleanMhmSample(const CFileConverter::SConfig& config,
-                                     CConverter& mhaConverter,
-                                     const mmt::isobmff::CSample& inSample, bool /*firstSample*/) {
-  mmt::isobmff::CSample outSample;
-  ILO_ASSERT(!inSample.rawData.empty(), "inSample rawData size is zero for MHM1 MP4");
+static constexpr uint32_t PACTYP_SYNC =
+    static_cast<uint32_t>(mmt::mhasparserlib::EMhasPacketType::PACTYP_SYNC);
+static constexpr uint32_t PACTYP_MPEGH3DACFG =
+    static_cast<uint32_t>(mmt::mhasparserlib::EMhasPacketType::PACTYP_MPEGH3DACFG);
 
-  // Iterate over mhas packets and patch config, if found
-  ilo::ByteBuffer newRawData;
-  mmt::mhasparserlib::CMhasParser mpeghMhasParser;
+//! Returns true for the sync packet as written by the MHAS packet writer.
+static bool isStandardSync(const uint8_t* data, const SMhasPacketHeader& packet) {
+  return packet.label == 0 && packet.payloadSize == 1 && data[packet.payloadOffset()] == 0xA5;
+}
+
+static uint32_t readUint32(const uint8_t* data) {
+  return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) | data[3];
+}
+
+static constexpr uint32_t BOX_TYPE_FTYP = 0x66747970;
+static constexpr uint32_t BOX_TYPE_MOOV = 0x6D6F6F76;
+static constexpr uint32_t BOX_TYPE_TRAK = 0x7472616B;
+static constexpr uint32_t BOX_TYPE_MDIA = 0x6D646961;
+static constexpr uint32_t BOX_TYPE_MINF = 0x6D696E66;
+static constexpr uint32_t BOX_TYPE_STBL = 0x7374626C;
+static constexpr uint32_t BOX_TYPE_STSD = 0x73747364;
+static constexpr uint32_t BOX_TYPE_MHM1 = 0x6D686D31;
+static constexpr uint32_t BOX_TYPE_MHAP = 0x6D686150;
+static constexpr uint32_t BOX_TYPE_MDAT = 0x6D646174;
+static constexpr uint32_t BOX_TYPE_MOOF = 0x6D6F6F66;
+//! The major brand written by the converter, see openWriter().
+static constexpr uint32_t BRAND_MP42 = 0x6D703432;
+
+//! Position of a box within a MP4 file.
+struct SBoxHeader {
+  uint32_t type = 0;
+  size_t offset = 0;
+  size_t headerSize = 0;
+  size_t size = 0;
+
+  size_t payloadOffset() const { return offset + headerSize; }
+  size_t payloadSize() const { return size - headerSize; }
+  size_t end() const { return offset + size; }
+};
+
+/*!
+ * Reads the header of the box at @p offset of @p data. Returns false if the box exceeds the
+ * enclosing range ending at @p end.
+ */
+static bool readBoxHeader(const uint8_t* data, size_t end, size_t offset, SBoxHeader& box) {
+  if (end - offset < 8) {
+    return false;
+  }
+  uint64_t boxSize = readUint32(data + offset);
+  box.type = readUint32(data + offset + 4);
+  box.offset = offset;
+  box.headerSize = 8;
+  if (boxSize == 1) {
+    if (end - offset < 16) {
+      return false;
+    }
+    boxSize = (static_cast<uint64_t>(readUint32(data + offset + 8)) << 32) |
+              readUint32(data + offset + 12);
+    box.headerSize = 16;
+  } else if (boxSize == 0) {
+    boxSize = end - offset;  // extends to the end of the enclosing range
+  }
+  if (boxSize < box.headerSize || boxSize > end - offset) {
+    return false;
+  }
+  box.size = static_cast<size_t>(boxSize);
+  return true;
+}
+
+//! Finds the first box of type @p type in the box sequence [@p begin, @p end) of @p data.
+static bool findBox(const uint8_t* data, size_t begin, size_t end, uint32_t type,
+                    SBoxHeader& box) {
+  for (size_t offset = begin; end - offset >= 8; offset = box.end()) {
+    if (!readBoxHeader(data, end, offset, box)) {
+      return false;
+    }
+    if (box.type == type) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*!
+ * Finds the payload of the only 'mdat' box of the MP4 file @p data. Returns false for fragmented
+ * files, multiple 'mdat' boxes and malformed top level boxes.
+ */
+static bool findMdatPayload(const uint8_t* data, size_t size, size_t& payloadOffset,
+                            size_t& payloadSize) {
+  bool found = false;
+  size_t offset = 0;
+  SBoxHeader box;
+  while (size - offset >= 8) {
+    if (!readBoxHeader(data, size, offset, box) || box.type == BOX_TYPE_MOOF) {
+      return false;
+    }
+    if (box.type == BOX_TYPE_MDAT) {
+      if (found) {
+        return false;
+      }
+      found = true;
+      payloadOffset = box.payloadOffset();
+      payloadSize = box.payloadSize();
+    }
+    offset = box.end();
+  }
+  return found && offset == size;
+}
+
+//! Container properties of a mhm1 file, which the converter writes anew.
+struct SContainerProperties {
+  uint32_t majorBrand = 0;
+  bool hasMhap = false;
+  //! The compatible sets of the 'mhaP' box.
+  ilo::ByteBuffer mhapSets;
+};
+
+/*!
+ * Reads the major brand and the 'mhaP' box of the 'mhm1' sample entry of the single track MP4 file
+ * @p data. Returns false if the file has no 'ftyp' box, no 'mhm1' sample entry or malformed boxes.
+ */
+static bool readContainerProperties(const uint8_t* data, size_t size,
+                                    SContainerProperties& properties) {
+  // the fields of 'stsd' in front of the sample entries and of an AudioSampleEntry in front of
+  // its child boxes
+  static constexpr size_t STSD_HEADER_SIZE = 8;
+  static constexpr size_t AUDIO_SAMPLE_ENTRY_SIZE = 28;
+
+  SBoxHeader box;
+  if (!findBox(data, 0, size, BOX_TYPE_FTYP, box) || box.payloadSize() < 4) {
+    return false;
+  }
+  properties.majorBrand = readUint32(data + box.payloadOffset());
+
+  size_t begin = 0;
+  size_t end = size;
+  for (uint32_t type : {BOX_TYPE_MOOV, BOX_TYPE_TRAK, BOX_TYPE_MDIA, BOX_TYPE_MINF, BOX_TYPE_STBL,
+                        BOX_TYPE_STSD}) {
+    if (!findBox(data, begin, end, type, box)) {
+      return false;
+    }
+    begin = box.payloadOffset();
+    end = box.end();
+  }
+  if (end - begin < STSD_HEADER_SIZE ||
+      !readBoxHeader(data, end, begin + STSD_HEADER_SIZE, box) || box.type != BOX_TYPE_MHM1 ||
+      box.payloadSize() < AUDIO_SAMPLE_ENTRY_SIZE) {
+    return false;
+  }
+
+  SBoxHeader mhap;
+  properties.hasMhap =
+      findBox(data, box.payloadOffset() + AUDIO_SAMPLE_ENTRY_SIZE, box.end(), BOX_TYPE_MHAP, mhap);
+  if (properties.hasMhap) {
+    const uint8_t* payload = data + mhap.payloadOffset();
+    if (mhap.payloadSize() < 1 || mhap.payloadSize() - 1 < payload[0]) {
+      return false;
+    }
+    properties.mhapSets.assign(payload + 1, payload + 1 + payload[0]);
+  }
+  return true;
+}
+
+/*!
+ * Returns true if the converter would write the track options of @p trackInfo (edit list, user
+ * data) unchanged with the options of @p config.
+ */
+static bool keepsTrackOptions(const CFileConverter::SConfig& config,
+                              const mmt::isobmff::CTrackInfo& trackInfo) {
+  if (!config.copyTrackUserData && !trackInfo.userData.empty()) {
+    return false;
+  }
+  if (!config.copyEditList) {
+    return trackInfo.editList.empty();
+  }
+  if (config.resetEditlistMediaTime) {
+    for (const auto& entry : trackInfo.editList) {
+      if (entry.mediaTime != 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+namespace {
+//! Checks whether cleaning MHAS packets would change them, see isCompliantMhmTrack().
+class CComplianceChecker {
+ public:
+  explicit CComplianceChecker(uint32_t packetLabel) : m_converter(openMhmConverter(packetLabel)) {}
+
+  //! Returns false if @p data isn't a sequence of complete packets or cleaning would change it.
+  bool check(const uint8_t* data, size_t size) {
+    SMhasPacketHeader packet;
+    for (size_t offset = 0; offset < size; offset = packet.end()) {
+      if (!readMhasPacketHeader(data, size, offset, packet)) {
+        return false;
+      }
+      if (packet.type == PACTYP_SYNC && !isStandardSync(data, packet)) {
+        return false;
+      }
+      if (packet.type == PACTYP_MPEGH3DACFG && !checkConfig(data, packet)) {
+        return false;
+      }
+    }
+    return size > 0;
+  }
+
+ private:
+  bool checkConfig(const uint8_t* data, const SMhasPacketHeader& packet) {
+    const uint8_t* packetBegin = data + packet.offset;
+    const uint8_t* packetEnd = data + packet.end();
+    const size_t packetSize = packet.end() - packet.offset;
+    // a repetition of the last config packet converts to the same bytes again
+    if (m_lastConfigPacket.size() == packetSize &&
+        std::equal(packetBegin, packetEnd, m_lastConfigPacket.begin())) {
+      return true;
+    }
+    m_payload.assign(data + packet.payloadOffset(), packetEnd);
+    if (m_converter->tryConvertConfig(m_payload, m_convertOutput) != EConversionStatus::OK ||
+        m_convertOutput.asi || m_convertOutput.config.size() != packetSize ||
+        !std::equal(packetBegin, packetEnd, m_convertOutput.config.begin())) {
+      return false;
+    }
+    m_lastConfigPacket.assign(packetBegin, packetEnd);
+    return true;
+  }
+
+  std::unique_ptr<CConverter> m_converter;
+  SMhasConfigOutput m_convertOutput;
+  ilo::ByteBuffer m_payload;
+  ilo::ByteBuffer m_lastConfigPacket;
+};
+}  // namespace
+
+bool isCompliantMhmTrack(const CFileConverter::SConfig& config,
+                         const mmt::isobmff::CTrackInfo& trackInfo,
+                         mmt::isobmff::CMpeghTrackReader& trackReader, uint64_t& bytes) {
+  bytes = 0;
+  if (!keepsTrackOptions(config, trackInfo)) {
+    return false;
+  }
+  SProfileLevel profileLevel;
+  if (auto mhaDcr = trackReader.mhaDecoderConfigRecord()) {
+    const ilo::ByteBuffer fileConfig = mhaDcr->mpegh3daConfig();
+    SMhasConfigOutput convertOutput;
+    if (openMhmConverter(config.packetLabel)->tryConvertConfig(fileConfig, convertOutput) !=
+            EConversionStatus::OK ||
+        convertOutput.asi || convertOutput.fullMpegHConfigBlob != fileConfig) {
+      return false;
+    }
+    profileLevel = convertOutput.compatibleProfileLevel;
+  }
+
+  // The converter writes a new container, its brand and 'mhaP' box have to match the input
+  CMappedFile mappedFile(config.inputFile);
+  SContainerProperties properties;
+  if (!mappedFile.isValid() ||
+      !readContainerProperties(mappedFile.data(), mappedFile.size(), properties) ||
+      properties.majorBrand != BRAND_MP42 || properties.hasMhap != config.copyMhap ||
+      (properties.hasMhap && properties.mhapSets != ilo::ByteBuffer{profileLevel.get()})) {
+    return false;
+  }
+
+  // The samples of an unfragmented mhm1 file form one MHAS stream in the 'mdat' box
+  size_t mdatOffset = 0;
+  size_t mdatSize = 0;
+  if (findMdatPayload(mappedFile.data(), mappedFile.size(), mdatOffset, mdatSize) &&
+      CComplianceChecker(config.packetLabel).check(mappedFile.data() + mdatOffset, mdatSize)) {
+    bytes = mdatSize;
+    return true;
+  }
+
+  // e.g. fragmented files or other data interleaved with the samples
+  CComplianceChecker checker(config.packetLabel);
+  mmt::isobmff::CSample sample;
+  trackReader.nextSample(sample);
+  if (sample.empty()) {
+    return false;
+  }
+  while (!sample.empty()) {
+    if (!checker.check(sample.rawData.data(), sample.rawData.size())) {
+      return false;
+    }
+    bytes += sample.rawData.size();
+    trackReader.nextSample(sample);
+  }
+  return true;
+}
+
+//! Emits the events of a config packet found in sample @p sampleIndex.
+static void emitConfigPacketEvents(const CFileConverter::SConfig& config, uint64_t sampleIndex,
+                                   const mmt::mhasparserlib::CMhasConfigPacket& configPacket) {
+  emitEvent(config, EEventCode::CONFIG_PACKET_FOUND, sampleIndex, configPacket.payload().size());
+
+  // note: the full config parse is only needed for the event values
+  if (isSubscribed(config, EEventCode::CONFIG_PACKET_INFO)) {
+    mmt::mhasparserlib::CMhasConfigPacket::SConfig configInfo = configPacket.mhasConfigInfo();
+    emitEvent(config, EEventCode::CONFIG_PACKET_INFO, sampleIndex,
+              configInfo.profileLevelIndication, configInfo.referenceLayout->cicpSpeakerLayoutIdx);
+  }
+}
+
+CMhmSampleCleaner::CMhmSampleCleaner(const CFileConverter::SConfig& config,
+                                     CConverter& mhaConverter)
+    : m_config(config), m_mhaConverter(mhaConverter) {
   // note: we need to call sync on the mhas parser otherwise it won't return packets
-  mpeghMhasParser.sync();
-  mpeghMhasParser.feed(inSample.rawData);
-  mpeghMhasParser.parsePackets();
-  ilo::ByteBuffer packetOutBuffer;
+  m_parser.sync();
+}
+
+void CMhmSampleCleaner::clean(const mmt::isobmff::CSample& inSample, uint64_t sampleIndex,
+                              mmt::isobmff::CSample& outSample) {
+  ILO_ASSERT(!inSample.rawData.empty(), "inSample rawData size is zero for MHM1 MP4");
+  outSample.ctsOffset = inSample.ctsOffset;
+  outSample.duration = inSample.duration;
+  outSample.isSyncSample = false;
 
+  if (!splice(inSample, sampleIndex, outSample)) {
+    parseAndClean(inSample, sampleIndex, outSample);
+  }
+}
+
+/*!
+ * @brief Cleans the sample by splicing the converted config packets into the input bytes.
+ *
+ * Only the packet headers are read, the other packets are copied as byte ranges. This is identical
+ * to re-serializing all packets, because the header encoding is unique. Returns false without
+ * touching @p outSample if the sample needs the full parse (it isn't a sequence of complete
+ * packets or it contains a non-standard sync packet).
+ */
+bool CMhmSampleCleaner::splice(const mmt::isobmff::CSample& inSample, uint64_t sampleIndex,
+                               mmt::isobmff::CSample& outSample) {
+  const ilo::ByteBuffer& rawData = inSample.rawData;
+  if (!scanMhasPackets(rawData.data(), rawData.size(), m_packets)) {
+    return false;
+  }
+
+  bool hasSync = false;
+  bool hasConfig = false;
+  for (const auto& packet : m_packets) {
+    if (packet.type == PACTYP_SYNC) {
+      // syncs are rewritten, so only the standard sync packet is passed through unchanged
+      if (!isStandardSync(rawData.data(), packet)) {
+        return false;
+      }
+      hasSync = true;
+    } else if (packet.type == PACTYP_MPEGH3DACFG) {
+      hasConfig = true;
+    }
+  }
+
+  outSample.isSyncSample = hasSync;
+  ilo::ByteBuffer& newRawData = outSample.rawData;
+  if (!hasConfig) {
+    // the common case: nothing to patch
+    newRawData.assign(rawData.begin(), rawData.end());
+    return true;
+  }
+
+  newRawData.clear();
+  size_t copyBegin = 0;
+  for (const auto& packet : m_packets) {
+    if (packet.type != PACTYP_MPEGH3DACFG) {
+      continue;
+    }
+    newRawData.insert(newRawData.end(), rawData.begin() + copyBegin,
+                      rawData.begin() + packet.offset);
+    copyBegin = packet.end();
+
+    m_payload.assign(rawData.begin() + packet.payloadOffset(), rawData.begin() + packet.end());
+    if (isSubscribed(m_config, EEventCode::CONFIG_PACKET_FOUND) ||
+        isSubscribed(m_config, EEventCode::CONFIG_PACKET_INFO)) {
+      mmt::mhasparserlib::CMhasConfigPacket configPacket(static_cast<uint32_t>(packet.label),
+                                                         m_payload.cbegin(), m_payload.cend());
+      emitConfigPacketEvents(m_config, sampleIndex, configPacket);
+    }
+
+    SMhasConfigOutput convertOutput = m_mhaConverter.convertConfig(m_payload);
+    newRawData.insert(newRawData.end(), convertOutput.config.begin(), convertOutput.config.end());
+    if (convertOutput.asi) {
+      newRawData.insert(newRawData.end(), convertOutput.asi->begin(), convertOutput.asi->end());
+    }
+  }
+  newRawData.insert(newRawData.end(), rawData.begin() + copyBegin, rawData.end());
+  return true;
+}
+
+/*!
+ * @brief Cleans the sample by parsing and re-writing all of its MHAS packets.
+ *
+ * The parser is kept across samples, so it is only fed the complete packets of a sample. The bytes
+ * of a truncated last packet would otherwise be carried over into the next sample.
+ */
+void CMhmSampleCleaner::parseAndClean(const mmt::isobmff::CSample& inSample, uint64_t sampleIndex,
+                                      mmt::isobmff::CSample& outSample) {
+  const ilo::ByteBuffer& rawData = inSample.rawData;
+  size_t completeBytes = 0;
+  SMhasPacketHeader header;
+  while (readMhasPacketHeader(rawData.data(), rawData.size(), completeBytes, header)) {
+    completeBytes = header.end();
+  }
+  if (completeBytes == rawData.size()) {
+    m_parser.feed(rawData);
+  } else {
+    m_parserInput.assign(rawData.begin(), rawData.begin() + completeBytes);
+    m_parser.feed(m_parserInput);
+  }
+  m_parser.parsePackets();
+
+  // Iterate over mhas packets and patch config, if found
+  ilo::ByteBuffer& newRawData = outSample.rawData;
+  newRawData.clear();
   size_t packetCount = 0;
-  while (mmt::mhasparserlib::CUniqueMhasPacket mhasPacket = mpeghMhasParser.nextPacket()) {
+  while (mmt::mhasparserlib::CUniqueMhasPacket mhasPacket = m_parser.nextPacket()) {
     switch (mmt::mhasparserlib::EMhasPacketType(mhasPacket->packetType())) {
       case mmt::mhasparserlib::EMhasPacketType::PACTYP_SYNC: {
         // Re-write syncs
-        mmt::mhasparserlib::CMhasSyncPacket{}.writePacket(packetOutBuffer);
-        newRawData.insert(newRawData.end(), packetOutBuffer.begin(), packetOutBuffer.end());
+        mmt::mhasparserlib::CMhasSyncPacket{}.writePacket(m_packetOutBuffer);
+        newRawData.insert(newRawData.end(), m_packetOutBuffer.begin(), m_packetOutBuffer.end());
         outSample.isSyncSample = true;
         break;
       }
       case mmt::mhasparserlib::EMhasPacketType::PACTYP_MPEGH3DACFG: {
-        config.logCallback("convertMhmSample - found config packet");
         const auto* inConfigPacket =
             dynamic_cast<mmt::mhasparserlib::CMhasConfigPacket*>(mhasPacket.get());
-
-        mmt::mhasparserlib::CMhasConfigPacket::SConfig configInfo =
-            inConfigPacket->mhasConfigInfo();
-        config.logCallback("convertMhmSample - profileLevelIndication " +
-                           std::to_string(configInfo.profileLevelIndication));
-        config.logCallback("convertMhmSample - cicpSpeakerLayoutIdx " +
-                           std::to_string(configInfo.referenceLayout->cicpSpeakerLayoutIdx));
+        emitConfigPacketEvents(m_config, sampleIndex, *inConfigPacket);
 
         // Convert with the mhaConverter
-        SMhasConfigOutput convertOutput = mhaConverter.convertConfig(inConfigPacket->payload());
+        SMhasConfigOutput convertOutput = m_mhaConverter.convertConfig(inConfigPacket->payload());
 
         newRawData.insert(newRawData.end(), convertOutput.config.begin(),
                           convertOutput.config.end());
@@ -151,19 +546,14 @@ mmt::isobmff::CSample cleanMhmSample(const CFileConverter::SConfig& config,
         break;
       }
       default: {
-        mhasPacket->writePacket(packetOutBuffer);
-        newRawData.insert(newRawData.end(), packetOutBuffer.begin(), packetOutBuffer.end());
+        mhasPacket->writePacket(m_packetOutBuffer);
+        newRawData.insert(newRawData.end(), m_packetOutBuffer.begin(), m_packetOutBuffer.end());
         break;
       }
     }
     packetCount++;
   }
   ILO_ASSERT(packetCount > 0, "MhasPacketCount in an mhm1 MP4 sample was empty");
-
-  outSample.ctsOffset = inSample.ctsOffset;
-  outSample.duration = inSample.duration;
-  outSample.rawData = newRawData;
-  return outSample;
 }
 }  // namespace au2mhasconverterlib
 }  // namespace mmt
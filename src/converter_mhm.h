@@ -83,20 +83,69 @@ amm-info@iis.fraunhofer.de
 
 // System includes
 #include <memory>
+#include <string>
+#include <vector>
 
 // External includes
+#include "mmtisobmff/reader/trackreader.h"
 #include "mmtisobmff/types.h"
+#include "mmtmhasparserlib/mhasparser.h"
 
 // Internal includes
 #include "mmtau2mhasconverterlib/converter.h"
 #include "mmtau2mhasconverterlib/file_converter.h"
+#include "mhas_scan.h"
 
 namespace mmt {
 namespace au2mhasconverterlib {
 std::unique_ptr<CConverter> openMhmConverter(uint32_t packetLabel);
 
-mmt::isobmff::CSample cleanMhmSample(const CFileConverter::SConfig& config,
-                                     CConverter& mhaConverter,
-                                     const mmt::isobmff::CSample& inSample, bool firstSample);
+/*!
+ * @brief Returns true if converting the mhm1 file config.inputFile (read with @p trackReader) with
+ * @p config would change neither its file config, nor any sample, nor the container properties
+ * the converter writes anew (major brand, 'mhaP' box, edit list and user data of @p trackInfo).
+ *
+ * Only the distinct config packets are converted, all other packets are merely scanned. The 'mdat'
+ * box of unfragmented files is scanned in place from a memory mapping, otherwise the samples of
+ * @p trackReader are consumed. @p bytes is set to the size of the scanned sample data.
+ */
+bool isCompliantMhmTrack(const CFileConverter::SConfig& config,
+                         const mmt::isobmff::CTrackInfo& trackInfo,
+                         mmt::isobmff::CMpeghTrackReader& trackReader, uint64_t& bytes);
+
+/*!
+ * @brief Cleans the samples of a mhm1 track, i.e. converts their config packets.
+ *
+ * Keeps the scan results, the MHAS parser and the buffers across the samples of a track, so
+ * samples without a config packet don't allocate in steady state.
+ */
+class CMhmSampleCleaner {
+ public:
+  //! @p config and @p mhaConverter must outlive the cleaner.
+  CMhmSampleCleaner(const CFileConverter::SConfig& config, CConverter& mhaConverter);
+
+  /*!
+   * Cleans the MHM sample @p inSample into @p outSample.
+   *
+   * Passing the same @p outSample for all samples of a track reuses its buffer.
+   */
+  void clean(const mmt::isobmff::CSample& inSample, uint64_t sampleIndex,
+             mmt::isobmff::CSample& outSample);
+
+ private:
+  bool splice(const mmt::isobmff::CSample& inSample, uint64_t sampleIndex,
+              mmt::isobmff::CSample& outSample);
+  void parseAndClean(const mmt::isobmff::CSample& inSample, uint64_t sampleIndex,
+                     mmt::isobmff::CSample& outSample);
+
+  const CFileConverter::SConfig& m_config;
+  CConverter& m_mhaConverter;
+  std::vector<SMhasPacketHeader> m_packets;
+  ByteBuffer m_payload;
+  ByteBuffer m_packetOutBuffer;
+  mmt::mhasparserlib::CMhasParser m_parser;
+  //! Complete packets of a sample ending with a truncated packet, see parseAndClean().
+  ByteBuffer m_parserInput;
+};
 }  // namespace au2mhasconverterlib
 }  // namespace mmt
@@ -81,13 +81,16 @@ amm-info@iis.fraunhofer.de
 -----------------------------------------------------------------------------*/
 
 // System includes
+#include <cerrno>
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <string>
 
 // Internal includes
 #include "directories.h"
+#include "file_io.h"
 #include "helpers.h"
 #include "logging.h"
 
@@ -242,13 +245,35 @@ bool CDirectories::checkFileExists(const std::string& fileName) {
   return file.good();
 }
 
-void CDirectories::moveFile(const std::string& sourceFile, const std::string& destinationFile) {
-  {
-    std::ifstream in(sourceFile, std::ios::in | std::ios::binary);
-    std::ofstream out(destinationFile, std::ios::out | std::ios::binary);
-    out << in.rdbuf();
+uint64_t CDirectories::getFileSize(const std::string& fileName) {
+  std::ifstream file(fileName, std::ios::in | std::ios::binary | std::ios::ate);
+  if (!file.good()) {
+    return 0;
+  }
+  return static_cast<uint64_t>(file.tellg());
+}
+
+void CDirectories::moveFile(const std::string& sourceFile, const std::string& destinationFile,
+                           bool dropFromCache) {
+  if (std::rename(sourceFile.c_str(), destinationFile.c_str()) == 0) {
+    return;
   }
+#ifdef _WIN32
+  // rename() doesn't replace existing files on Windows
+  std::remove(destinationFile.c_str());
+  if (std::rename(sourceFile.c_str(), destinationFile.c_str()) == 0) {
+    return;
+  }
+#endif
+  ILO_ASSERT(errno == EXDEV, "Failed to move %s to %s: %s", sourceFile.c_str(),
+             destinationFile.c_str(), std::strerror(errno));
+
+  // Across file systems, the data has to be copied once
+  copyFile(sourceFile, destinationFile);
   std::remove(sourceFile.c_str());
+  if (dropFromCache) {
+    dropFileFromCache(destinationFile, true);
+  }
 }
 
 static std::size_t calculatePathDepth(const std::string& path, char separator) {
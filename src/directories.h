@@ -82,6 +82,7 @@ amm-info@iis.fraunhofer.de
 #pragma once
 
 // System includes
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -106,8 +107,12 @@ class CDirectories {
   static std::vector<CDirectories::SConversion> getFileConversionList(
       std::string inputDirectoryPath, std::string outputDirectoryPath, bool createFolders,
       bool includeSubfolders, bool addMhmSuffix);
-  static void moveFile(const std::string& sourceFile, const std::string& destinationFile);
+  // Renames the file, copying it only across file systems. dropFromCache drops the pages of the
+  // copy from the page cache (see dropFileFromCache). Throws if the file can't be moved.
+  static void moveFile(const std::string& sourceFile, const std::string& destinationFile,
+                       bool dropFromCache = false);
   static bool checkFileExists(const std::string& fileName);
+  static uint64_t getFileSize(const std::string& fileName);
 };
 }  // namespace au2mhasconverterlib
 }  // namespace mmt
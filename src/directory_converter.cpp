@@ -82,15 +82,25 @@ amm-info@iis.fraunhofer.de
 
 // System includes
 #include <exception>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
 
+// External includes
+#include "ilo/memory.h"
+
 // Project includes
 #include "mmtau2mhasconverterlib/directory_converter.h"
 #include "mmtau2mhasconverterlib/file_converter.h"
+#include "conversion_report.h"
 #include "directories.h"
 #include "file_converter_pimpl.h"
+#include "logging.h"
+#include "lookahead_prefetcher.h"
+#include "probes.h"
+#include "stopwatch.h"
+#include "trace_recorder.h"
 
 namespace mmt {
 namespace au2mhasconverterlib {
@@ -102,6 +112,134 @@ std::string CDirectoryConverter::getVersion() const {
          std::to_string(mmtau2mhasconverterlib_VERSION_PATCH);
 }
 
+enum class EJobResult { SUCCEEDED, EXISTED, SKIPPED, FAILED, CANCELLED };
+
+static EJobResult convertEntry(const CDirectoryConverter::SConfig& config,
+                               const CDirectories::SConversion& entry, size_t jobIndex,
+                               size_t numJobs, CConversionReport* report,
+                               const std::shared_ptr<CTraceRecorder>& traceRecorder) {
+  // The internal log messages of the job go to the asynchronous sink as well (if set)
+  logging::CThreadLogSinkScope logSinkScope(config.asyncLogSink.get(), jobIndex);
+
+  SConversionReportEntry reportEntry;
+  reportEntry.inputFile = entry.inputFile;
+  reportEntry.outputFile = entry.outputFile;
+  if (report) {
+    reportEntry.inputBytes = CDirectories::getFileSize(entry.inputFile);
+  }
+
+  // Log status status
+  {
+    std::stringstream sstream{};
+    sstream << "Converting " << jobIndex << " of " << numJobs << "...";
+    sstream << ((entry.inputFile.size() > 48) ? entry.inputFile.substr(entry.inputFile.size() - 48)
+                                              : entry.inputFile)
+            << std::endl;
+    config.logCallback(sstream.str());
+  }
+
+  if (!config.replaceFiles) {
+    if (CDirectories::checkFileExists(entry.outputFile)) {
+      std::stringstream sstream{};
+      sstream << "[ ] Skipping conversion of file that already exists (replaceFiles=Off) "
+              << entry.outputFile << std::endl;
+      config.logCallback(sstream.str());
+      if (report) {
+        reportEntry.status = "existed";
+        report->add(reportEntry);
+      }
+      return EJobResult::EXISTED;
+    }
+  }
+
+  CFileConverter::SConfig converterConfig;
+  converterConfig.inputFile = entry.inputFile;
+  converterConfig.outputFile = entry.outputFile + ".tmp";
+  converterConfig.logCallback = config.logCallback;
+  converterConfig.eventCallback = config.eventCallback;
+  converterConfig.eventMask = config.eventMask;
+  if (config.asyncLogSink) {
+    converterConfig.logCallback = config.asyncLogSink->logCallback(jobIndex);
+    converterConfig.eventCallback = config.asyncLogSink->eventCallback(jobIndex);
+  }
+  converterConfig.progressCallback = config.progressCallback;
+  converterConfig.interruptCallback = config.interruptCallback;
+  converterConfig.compliantMhmHandling = config.compliantMhmHandling;
+  converterConfig.inputPrefetchDepth = config.inputPrefetchDepth;
+  converterConfig.inputPrefetchChunkSize = config.inputPrefetchChunkSize;
+  converterConfig.dropInputFromCache = config.dropInputFromCache;
+  converterConfig.writeBehindOutput = config.writeBehindOutput;
+
+  AU2MHAS_PROBE2(job__start, static_cast<uint64_t>(jobIndex), entry.inputFile.c_str());
+  CTraceSpan jobSpan(traceRecorder.get(), "job", "directory");
+  jobSpan.addArg("index", static_cast<uint64_t>(jobIndex));
+  jobSpan.setDetail(entry.inputFile);
+
+  CFileConverterPimpl converter(converterConfig, traceRecorder);
+  auto addReportEntry = [&](const std::string& status, const std::string& error) {
+    if (!report) {
+      return;
+    }
+    const SFileConversionStatistics& statistics = converter.statistics();
+    reportEntry.status = status;
+    reportEntry.error = error;
+    reportEntry.samples = statistics.samples;
+    reportEntry.ipfs = statistics.ipfs;
+    reportEntry.configChanges = statistics.configChanges;
+    reportEntry.openNs = statistics.openNs;
+    reportEntry.readNs = statistics.readNs;
+    reportEntry.convertNs = statistics.convertNs;
+    reportEntry.writeNs = statistics.writeNs;
+    report->add(reportEntry);
+  };
+
+  try {
+    converter.process();
+  } catch (const std::exception& ex) {
+    std::stringstream sstream{};
+    sstream << "[E] Conversion of file " << entry.inputFile << " failed with " << ex.what()
+            << std::endl;
+    config.logCallback(sstream.str());
+    addReportEntry("failed", ex.what());
+    AU2MHAS_PROBE2(job__end, static_cast<uint64_t>(jobIndex), static_cast<int32_t>(0));
+    return EJobResult::FAILED;
+  }
+
+  if (config.interruptCallback()) {
+    config.logCallback("Conversion stopped by user");
+    addReportEntry("cancelled", "");
+    AU2MHAS_PROBE2(job__end, static_cast<uint64_t>(jobIndex), static_cast<int32_t>(0));
+    return EJobResult::CANCELLED;
+  }
+
+  if (converter.statistics().compliantInput &&
+      config.compliantMhmHandling == ECompliantInputHandling::SKIP) {
+    addReportEntry("skipped", "");
+    AU2MHAS_PROBE2(job__end, static_cast<uint64_t>(jobIndex), static_cast<int32_t>(1));
+    return EJobResult::SKIPPED;
+  }
+
+  CStopwatch publishStopwatch;
+  try {
+    CDirectories::moveFile(entry.outputFile + ".tmp", entry.outputFile, config.writeBehindOutput);
+  } catch (const std::exception& ex) {
+    // one output that can't be published must not abort the batch
+    std::stringstream sstream{};
+    sstream << "[E] Publishing of file " << entry.outputFile << " failed with " << ex.what()
+            << std::endl;
+    config.logCallback(sstream.str());
+    reportEntry.publishNs = publishStopwatch.elapsedNs();
+    addReportEntry("failed", ex.what());
+    AU2MHAS_PROBE2(job__end, static_cast<uint64_t>(jobIndex), static_cast<int32_t>(0));
+    return EJobResult::FAILED;
+  }
+  reportEntry.publishNs = publishStopwatch.elapsedNs();
+  reportEntry.outputBytes = CDirectories::getFileSize(entry.outputFile);
+  addReportEntry("succeeded", "");
+  AU2MHAS_PROBE2(job__end, static_cast<uint64_t>(jobIndex), static_cast<int32_t>(1));
+  return EJobResult::SUCCEEDED;
+}
+
 void CDirectoryConverter::process() {
   std::vector<CDirectories::SConversion> conversionList =
       CDirectories::getFileConversionList(m_config.inputDirectoryPath, m_config.outputDirectoryPath,
@@ -117,57 +255,41 @@ void CDirectoryConverter::process() {
     m_config.logCallback(sstream.str());
   }
 
-  size_t no = 0;
-  size_t succeeded = 0;
-  size_t existed = 0;
-  for (const CDirectories::SConversion& entry : conversionList) {
-    // Log status status
-    {
-      std::stringstream sstream{};
-      sstream << "Converting " << no++ << " of " << conversionList.size() << "...";
-      sstream << ((entry.inputFile.size() > 48)
-                      ? entry.inputFile.substr(entry.inputFile.size() - 48)
-                      : entry.inputFile)
-              << std::endl;
-      m_config.logCallback(sstream.str());
-    }
+  std::unique_ptr<CConversionReport> report;
+  if (!m_config.reportFilePath.empty()) {
+    report = ilo::make_unique<CConversionReport>(m_config.reportFilePath, m_config.reportFormat);
+  }
 
-    if (!m_config.replaceFiles) {
-      if (CDirectories::checkFileExists(entry.outputFile)) {
-        std::stringstream sstream{};
-        sstream << "[ ] Skipping conversion of file that already exists (replaceFiles=Off) "
-                << entry.outputFile << std::endl;
-        m_config.logCallback(sstream.str());
-        existed++;
-        continue;
-      }
-    }
+  std::shared_ptr<CTraceRecorder> traceRecorder;
+  if (!m_config.traceFilePath.empty()) {
+    traceRecorder = std::make_shared<CTraceRecorder>(m_config.traceFilePath);
+  }
 
-    CFileConverter::SConfig converterConfig;
-    converterConfig.inputFile = entry.inputFile;
-    converterConfig.outputFile = entry.outputFile + ".tmp";
-    converterConfig.logCallback = m_config.logCallback;
-    converterConfig.progressCallback = m_config.progressCallback;
-    converterConfig.interruptCallback = m_config.interruptCallback;
-
-    try {
-      CFileConverterPimpl converter(converterConfig);
-      converter.process();
-    } catch (const std::exception& ex) {
-      std::stringstream sstream{};
-      sstream << "[E] Conversion of file " << entry.inputFile << " failed with " << ex.what()
-              << std::endl;
-      m_config.logCallback(sstream.str());
-      continue;
+  std::unique_ptr<CLookaheadPrefetcher> prefetcher;
+  if (m_config.lookaheadFiles > 0) {
+    std::vector<std::string> inputFiles;
+    for (const CDirectories::SConversion& entry : conversionList) {
+      inputFiles.push_back(entry.inputFile);
     }
+    prefetcher = ilo::make_unique<CLookaheadPrefetcher>(
+        std::move(inputFiles), m_config.lookaheadFiles, m_config.lookaheadMdatBytes);
+  }
 
-    if (m_config.interruptCallback()) {
-      m_config.logCallback("Conversion stopped by user");
+  size_t succeeded = 0;
+  size_t existed = 0;
+  size_t skipped = 0;
+  for (size_t jobIndex = 0; jobIndex < conversionList.size(); ++jobIndex) {
+    if (prefetcher) {
+      prefetcher->started(jobIndex);
+    }
+    const EJobResult result = convertEntry(m_config, conversionList[jobIndex], jobIndex,
+                                           conversionList.size(), report.get(), traceRecorder);
+    if (result == EJobResult::CANCELLED) {
       break;
     }
-
-    CDirectories::moveFile(entry.outputFile + ".tmp", entry.outputFile);
-    succeeded++;
+    succeeded += result == EJobResult::SUCCEEDED ? 1 : 0;
+    existed += result == EJobResult::EXISTED ? 1 : 0;
+    skipped += result == EJobResult::SKIPPED ? 1 : 0;
   }
 
   {
@@ -175,7 +297,8 @@ void CDirectoryConverter::process() {
     sstream << "Conversion completed [ ";
     sstream << succeeded << " succeeded, ";
     sstream << existed << " existed, ";
-    sstream << (conversionList.size() - succeeded - existed) << " failed of ";
+    sstream << skipped << " skipped, ";
+    sstream << (conversionList.size() - succeeded - existed - skipped) << " failed of ";
     sstream << conversionList.size() << " files ]" << std::endl;
     m_config.logCallback(sstream.str());
   }
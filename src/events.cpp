@@ -0,0 +1,138 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// System includes
+#include <string>
+
+// Internal includes
+#include "mmtau2mhasconverterlib/events.h"
+#include "event_helpers.h"
+
+namespace mmt {
+namespace au2mhasconverterlib {
+std::string formatEvent(const SEvent& event) {
+  switch (event.code) {
+    case EEventCode::PROFILE_LEVEL:
+      return "Profile Level " + std::to_string(event.values[0]);
+    case EEventCode::MISSING_FILE_CONFIG:
+      return "WARN: No Config on MP4-Level of input file, will write no MP4-Level Config";
+    case EEventCode::FIRST_SAMPLE_NOT_IPF:
+      return "First sample is not an IPF, playback will may not be possible until the first IPF "
+             "has been received.";
+    case EEventCode::SYNC_INSERTED:
+      switch (static_cast<ESyncReason>(event.values[0])) {
+        case ESyncReason::EVERY_FRAME:
+          return "Inserting Sync before every Frame";
+        case ESyncReason::FIRST_FRAME:
+          return "Inserting Sync before first Frame";
+        case ESyncReason::IPF:
+          return "Inserting Sync before IPF";
+      }
+      break;
+    case EEventCode::CONFIG_PACKET_FOUND:
+      return "convertMhmSample - found config packet";
+    case EEventCode::CONFIG_PACKET_INFO:
+      return "convertMhmSample - profileLevelIndication " + std::to_string(event.values[0]) +
+             ", cicpSpeakerLayoutIdx " + std::to_string(event.values[1]);
+  }
+  return "Unknown event " + std::to_string(static_cast<uint32_t>(event.code));
+}
+
+void emitEvent(const SConfigCommon& config, EEventCode code, uint64_t sampleIndex,
+               uint64_t value0, uint64_t value1) {
+  if (!isSubscribed(config, code)) {
+    return;
+  }
+  SEvent event;
+  event.code = code;
+  event.sampleIndex = sampleIndex;
+  event.values[0] = value0;
+  event.values[1] = value1;
+  // note: text is only formatted if no client consumes the structured event
+  if (config.eventCallback) {
+    config.eventCallback(event);
+  } else {
+    config.logCallback(formatEvent(event));
+  }
+}
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
@@ -104,5 +104,9 @@ CFileConverter::~CFileConverter() noexcept = default;
 void CFileConverter::process() {
   m_pimpl->process();
 }
+
+const SFileConversionStatistics& CFileConverter::statistics() const {
+  return m_pimpl->statistics();
+}
 }  // namespace au2mhasconverterlib
 }  // namespace mmt
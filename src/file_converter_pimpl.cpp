@@ -84,9 +84,11 @@ amm-info@iis.fraunhofer.de
 #include <exception>
 #include <memory>
 #include <string>
+#include <utility>
 
 // External includes
 #include "ilo/common_types.h"
+#include "ilo/memory.h"
 #include "mmtisobmff/reader/reader.h"
 #include "mmtisobmff/reader/trackreader.h"
 #include "mmtisobmff/writer/trackwriter.h"
@@ -96,22 +98,87 @@ amm-info@iis.fraunhofer.de
 #include "converter_helpers.h"
 #include "converter_mha.h"
 #include "converter_mhm.h"
+#include "event_helpers.h"
 #include "file_converter_pimpl.h"
+#include "file_io.h"
+#include "input_prefetcher.h"
 #include "logging.h"
+#include "probes.h"
+#include "stopwatch.h"
+#include "trace_recorder.h"
 
 using namespace mmt::au2mhasconverterlib;
 
-CFileConverterPimpl::CFileConverterPimpl(const CFileConverter::SConfig& config)
-    : m_config(config) {}
+namespace {
+//! Drops the input file from the page cache on scope exit (if a path is given).
+class CInputCacheDrop {
+ public:
+  explicit CInputCacheDrop(std::string inputFile) : m_inputFile(std::move(inputFile)) {}
+  ~CInputCacheDrop() {
+    if (!m_inputFile.empty()) {
+      dropFileFromCache(m_inputFile, false);
+    }
+  }
+  CInputCacheDrop(const CInputCacheDrop&) = delete;
+  CInputCacheDrop& operator=(const CInputCacheDrop&) = delete;
+
+ private:
+  const std::string m_inputFile;
+};
+}  // namespace
+
+//! Output bytes after which the write-back of the output file is advanced.
+static constexpr uint64_t WRITE_BEHIND_INTERVAL = 8 * 1024 * 1024;
+
+CFileConverterPimpl::CFileConverterPimpl(const CFileConverter::SConfig& config,
+                                         std::shared_ptr<CTraceRecorder> traceRecorder)
+    : m_config(config), m_traceRecorder(std::move(traceRecorder)) {}
 
 void CFileConverterPimpl::process() {
   m_config.logCallback("Start processing on " + m_config.inputFile + " to " + m_config.outputFile);
+  m_statistics = SFileConversionStatistics{};
+  if (!m_traceRecorder && !m_config.traceFilePath.empty()) {
+    m_traceRecorder = std::make_shared<CTraceRecorder>(m_config.traceFilePath);
+  }
+  CTraceRecorder* tracer = m_traceRecorder.get();
+  CStopwatch stopwatch;
+  // on scope exit, so cancelled and failed conversions drop the input as well
+  CInputCacheDrop inputCacheDrop(m_config.dropInputFromCache ? m_config.inputFile : "");
+
+  std::unique_ptr<CInputPrefetcher> prefetcher;
+  if (m_config.inputPrefetchDepth > 0) {
+    prefetcher = ilo::make_unique<CInputPrefetcher>(m_config.inputFile, m_config.inputPrefetchDepth,
+                                                    m_config.inputPrefetchChunkSize);
+  }
 
   std::unique_ptr<mmt::isobmff::CIsobmffReader> reader;
   std::unique_ptr<mmt::isobmff::CMpeghTrackReader> trackReader;
-  auto trackInfo = openReader(m_config.inputFile, reader, trackReader);
+  auto trackInfo = [&]() {
+    CTraceSpan span(tracer, "openReader", "io");
+    return openReader(m_config.inputFile, reader, trackReader);
+  }();
   mmt::isobmff::Codec codec = reader->trackInfos()[0].codec;
 
+  if (codec == mmt::isobmff::Codec::mpegh_mhm &&
+      m_config.compliantMhmHandling != ECompliantInputHandling::CONVERT) {
+    bool compliant = false;
+    {
+      CTraceSpan span(tracer, "compliancePrecheck", "convert");
+      compliant = isCompliantMhmTrack(m_config, trackInfo, *trackReader, m_statistics.bytesIn);
+    }
+    m_statistics.readNs += stopwatch.lap();
+    if (compliant) {
+      m_statistics.samples = trackInfo.sampleCount;
+      processCompliantInput(stopwatch);
+      return;
+    }
+
+    // the pre-pass may have consumed the samples, start over
+    m_statistics.bytesIn = 0;
+    CTraceSpan span(tracer, "openReader", "io");
+    trackInfo = openReader(m_config.inputFile, reader, trackReader);
+  }
+
   std::unique_ptr<CConverter> mhaConverter;
   ilo::ByteBuffer mpeghConfigFromMp4;
 
@@ -138,8 +205,7 @@ void CFileConverterPimpl::process() {
     auto mhaConverter2 = openMhaConverter(m_config.packetLabel);
 
     converterOut = mhaConverter2->convertConfig(mhaDcrBinaryBlob);
-    m_config.logCallback("Profile Level " +
-                         std::to_string(converterOut.compatibleProfileLevel.get()));
+    emitEvent(m_config, EEventCode::PROFILE_LEVEL, 0, converterOut.compatibleProfileLevel.get());
     ilo::ByteBuffer mhaDcrBinaryBlobConverted = converterOut.fullMpegHConfigBlob;
 
     // move over also the outer shell of CMhaDecoderConfigRecord. The mpegh3daConfig Binary Blob is
@@ -147,38 +213,100 @@ void CFileConverterPimpl::process() {
     mhaDcrConverted = std::move(mhaDcr);
     mhaDcrConverted->setMpegh3daConfig(mhaDcrBinaryBlobConverted);
   } else {
-    m_config.logCallback(
-        "WARN: No Config on MP4-Level of input file, will write no MP4-Level Config");
+    emitEvent(m_config, EEventCode::MISSING_FILE_CONFIG, 0);
   }
 
   std::unique_ptr<mmt::isobmff::CIsobmffWriter> writer;
   std::unique_ptr<mmt::isobmff::CMpeghTrackWriter> trackWriter;
-  openWriter(m_config, writer, trackWriter, reader, trackInfo, trackReader,
-             std::move(mhaDcrConverted), converterOut.compatibleProfileLevel.get());
+  {
+    CTraceSpan span(tracer, "openWriter", "io");
+    openWriter(m_config, writer, trackWriter, reader, trackInfo, trackReader,
+               std::move(mhaDcrConverted), converterOut.compatibleProfileLevel.get());
+  }
+  std::unique_ptr<CWriteBehind> writeBehind;
+  if (m_config.writeBehindOutput) {
+    writeBehind = ilo::make_unique<CWriteBehind>(m_config.outputFile);
+  }
+  uint64_t writeBehindBytes = 0;
+  m_statistics.openNs = stopwatch.lap();
 
   mmt::isobmff::CSample inSample;
   trackReader->nextSample(inSample);
+  m_statistics.readNs += stopwatch.lap();
 
   size_t totalLoops = reader->trackInfos()[0].sampleCount;
   if (totalLoops == 0) {
     ILO_FAIL("Input file contains no samples.");
   }
 
-  bool firstSample = true;
+  // reused across the samples to avoid per-sample allocations
+  SMhasFrameOutput frameScratch;
+  mmt::isobmff::CSample outSample;
+  CMhmSampleCleaner mhmCleaner(m_config, *mhaConverter);
+
   size_t currentLoop = 0;
   while (!inSample.empty()) {
-    mmt::isobmff::CSample outSample;
+    const SConverterStatistics converterStatistics = mhaConverter->statistics();
+    const uint32_t packetLabel = mhaConverter->currentPacketLabel();
+    CTraceSpan sampleSpan(tracer, "sample", "convert");
+    sampleSpan.addArg("index", currentLoop);
+    sampleSpan.addArg("bytes", inSample.rawData.size());
+    AU2MHAS_PROBE2(sample__begin, static_cast<uint64_t>(currentLoop),
+                   static_cast<uint64_t>(inSample.rawData.size()));
+
+    bool randomAccess = false;
     if (codec == mmt::isobmff::Codec::mpegh_mha) {
-      outSample =
-          convertMhaSampleToMhm(m_config, *mhaConverter, inSample, mpeghConfigFromMp4, firstSample);
+      convertMhaSampleToMhm(m_config, *mhaConverter, inSample, mpeghConfigFromMp4, currentLoop,
+                            frameScratch, outSample);
+      randomAccess = mhaConverter->statistics().ipfs != converterStatistics.ipfs;
     } else if (codec == mmt::isobmff::Codec::mpegh_mhm) {
-      outSample = cleanMhmSample(m_config, *mhaConverter, inSample, firstSample);
+      mhmCleaner.clean(inSample, currentLoop, outSample);
+      // In MHM streams, every sample carrying a config packet is a random access point
+      randomAccess =
+          mhaConverter->statistics().configConversions != converterStatistics.configConversions;
     }
     ILO_ASSERT(!outSample.rawData.empty(), "sample raw data is empty after patch");
+    if (randomAccess) {
+      ++m_statistics.ipfs;
+      if (tracer) {
+        tracer->instant("ipf", "convert", "index", currentLoop);
+      }
+    }
+    if (mhaConverter->currentPacketLabel() != packetLabel) {
+      ++m_statistics.configChanges;
+      if (tracer) {
+        tracer->instant("configChange", "convert", "packetLabel",
+                        mhaConverter->currentPacketLabel());
+      }
+    }
+    m_statistics.bytesIn += inSample.rawData.size();
+    m_statistics.bytesOut += outSample.rawData.size();
+    if (prefetcher) {
+      prefetcher->setConsumedSampleBytes(m_statistics.bytesIn);
+    }
+    ++m_statistics.samples;
+
+    const SConverterStatistics& newConverterStatistics = mhaConverter->statistics();
+    uint64_t convertNs = stopwatch.lap();
+    uint64_t converterNs =
+        (newConverterStatistics.convertConfigNs - converterStatistics.convertConfigNs) +
+        (newConverterStatistics.convertFrameNs - converterStatistics.convertFrameNs) +
+        (newConverterStatistics.convertIpfNs - converterStatistics.convertIpfNs);
+    m_statistics.convertNs += convertNs;
+    m_statistics.sampleAssemblyNs += convertNs > converterNs ? convertNs - converterNs : 0;
+    m_statistics.converter = newConverterStatistics;
+    AU2MHAS_PROBE2(sample__end, static_cast<uint64_t>(currentLoop),
+                   static_cast<uint64_t>(outSample.rawData.size()));
+
     trackWriter->addSample(outSample);
+    if (writeBehind && m_statistics.bytesOut - writeBehindBytes >= WRITE_BEHIND_INTERVAL) {
+      writeBehind->update();
+      writeBehindBytes = m_statistics.bytesOut;
+    }
+    m_statistics.writeNs += stopwatch.lap();
 
     trackReader->nextSample(inSample);
-    firstSample = false;
+    m_statistics.readNs += stopwatch.lap();
 
     if (m_config.interruptCallback()) {
       return;
@@ -190,7 +318,17 @@ void CFileConverterPimpl::process() {
     if (progress <= 100) {
       m_config.progressCallback(static_cast<uint16_t>(progress));
     }
+    stopwatch.lap();
+  }
+
+  // Finalizing the writers flushes the remaining sample data and the movie header
+  {
+    CTraceSpan span(tracer, "flush", "io");
+    trackWriter.reset();
+    writer.reset();
+    writeBehind.reset();
   }
+  m_statistics.writeNs += stopwatch.lap();
 
   m_config.progressCallback(100);
   if (m_config.interruptCallback()) {
@@ -199,3 +337,21 @@ void CFileConverterPimpl::process() {
     m_config.logCallback("Processing Thread Finished");
   }
 }
+
+void CFileConverterPimpl::processCompliantInput(CStopwatch& stopwatch) {
+  m_statistics.compliantInput = true;
+  if (m_config.compliantMhmHandling == ECompliantInputHandling::COPY) {
+    CTraceSpan span(m_traceRecorder.get(), "copyInput", "io");
+    copyFile(m_config.inputFile, m_config.outputFile);
+    m_statistics.bytesOut = m_statistics.bytesIn;
+    if (m_config.writeBehindOutput) {
+      dropFileFromCache(m_config.outputFile, true);
+    }
+    m_statistics.writeNs += stopwatch.lap();
+    m_config.logCallback("Input is already compliant, copied it to " + m_config.outputFile);
+  } else {
+    m_config.logCallback("Input is already compliant, skipped writing " + m_config.outputFile);
+  }
+  m_config.progressCallback(100);
+  m_config.logCallback("Processing Thread Finished");
+}
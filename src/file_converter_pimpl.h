@@ -81,19 +81,38 @@ amm-info@iis.fraunhofer.de
 -----------------------------------------------------------------------------*/
 #pragma once
 
+// System includes
+#include <memory>
+
 // Internal includes
 #include "mmtau2mhasconverterlib/version.h"
 #include "mmtau2mhasconverterlib/file_converter.h"
 
 namespace mmt {
 namespace au2mhasconverterlib {
+class CStopwatch;
+class CTraceRecorder;
+
 class CFileConverterPimpl {
  public:
-  CFileConverterPimpl(const CFileConverter::SConfig& config);
+  /*!
+   * @brief Creates the converter, the trace recorder is shared when converting multiple files.
+   *
+   * Without a trace recorder, a private one is created if config.traceFilePath is set.
+   */
+  CFileConverterPimpl(const CFileConverter::SConfig& config,
+                      std::shared_ptr<CTraceRecorder> traceRecorder = nullptr);
   void process();
 
+  const SFileConversionStatistics& statistics() const { return m_statistics; }
+
  private:
+  //! Copies or skips the input found to be compliant by the pre-pass.
+  void processCompliantInput(CStopwatch& stopwatch);
+
   const CFileConverter::SConfig m_config;
+  SFileConversionStatistics m_statistics;
+  std::shared_ptr<CTraceRecorder> m_traceRecorder;
 };
 }  // namespace au2mhasconverterlib
 }  // namespace mmt
@@ -0,0 +1,392 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// System includes
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Internal includes
+#include "file_io.h"
+#include "logging.h"
+
+using namespace mmt::au2mhasconverterlib;
+
+#if defined(__unix__) || defined(__APPLE__)
+namespace {
+//! Closes the file descriptor on scope exit.
+class CFileDescriptor {
+ public:
+  explicit CFileDescriptor(int fd) : m_fd(fd) {}
+  ~CFileDescriptor() {
+    if (m_fd >= 0) {
+      close(m_fd);
+    }
+  }
+  CFileDescriptor(const CFileDescriptor&) = delete;
+  CFileDescriptor& operator=(const CFileDescriptor&) = delete;
+
+  int get() const { return m_fd; }
+
+ private:
+  int m_fd;
+};
+
+bool copyWithReadWrite(int inFd, uint64_t inOffset, int outFd, uint64_t outOffset,
+                       uint64_t length) {
+  std::vector<uint8_t> buffer(static_cast<size_t>(std::min<uint64_t>(length, 1u << 20)));
+  while (length > 0) {
+    const size_t chunk = static_cast<size_t>(std::min<uint64_t>(length, buffer.size()));
+    const ssize_t bytesRead = pread(inFd, buffer.data(), chunk, static_cast<off_t>(inOffset));
+    if (bytesRead < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytesRead <= 0) {
+      return false;
+    }
+    size_t written = 0;
+    while (written < static_cast<size_t>(bytesRead)) {
+      const ssize_t result = pwrite(outFd, buffer.data() + written,
+                                    static_cast<size_t>(bytesRead) - written,
+                                    static_cast<off_t>(outOffset + written));
+      if (result < 0 && errno == EINTR) {
+        continue;
+      }
+      if (result <= 0) {
+        return false;
+      }
+      written += static_cast<size_t>(result);
+    }
+    inOffset += written;
+    outOffset += written;
+    length -= written;
+  }
+  return true;
+}
+}  // namespace
+#endif
+
+bool mmt::au2mhasconverterlib::copyFileRange(int inFd, uint64_t inOffset, int outFd,
+                                             uint64_t outOffset, uint64_t length) {
+#if defined(__linux__)
+  while (length > 0) {
+    auto in = static_cast<loff_t>(inOffset);
+    auto out = static_cast<loff_t>(outOffset);
+    const ssize_t copied = copy_file_range(inFd, &in, outFd, &out, static_cast<size_t>(length), 0);
+    if (copied > 0) {
+      inOffset += static_cast<uint64_t>(copied);
+      outOffset += static_cast<uint64_t>(copied);
+      length -= static_cast<uint64_t>(copied);
+      continue;
+    }
+    if (copied < 0 && errno == EINTR) {
+      continue;
+    }
+    // Some file systems (e.g. procfs or FUSE mounts) report 0 bytes before the end of the input,
+    // the read/write fallback distinguishes that from a truncated input.
+    if (copied == 0) {
+      break;
+    }
+    // e.g. a kernel without copy_file_range, different file systems before Linux 5.3 or pipes
+    if (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP) {
+      break;
+    }
+    return false;
+  }
+  return length == 0 || copyWithReadWrite(inFd, inOffset, outFd, outOffset, length);
+#elif defined(__unix__) || defined(__APPLE__)
+  return copyWithReadWrite(inFd, inOffset, outFd, outOffset, length);
+#else
+  (void)inFd;
+  (void)inOffset;
+  (void)outFd;
+  (void)outOffset;
+  (void)length;
+  return false;
+#endif
+}
+
+void mmt::au2mhasconverterlib::copyFile(const std::string& inputFile,
+                                        const std::string& outputFile) {
+#if defined(__unix__) || defined(__APPLE__)
+  CFileDescriptor in(open(inputFile.c_str(), O_RDONLY));
+  ILO_ASSERT(in.get() >= 0, "Failed to open input file %s", inputFile.c_str());
+  struct stat inStat;
+  const int statResult = fstat(in.get(), &inStat);
+  ILO_ASSERT(statResult == 0, "Failed to stat input file %s", inputFile.c_str());
+
+  CFileDescriptor out(open(outputFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+  ILO_ASSERT(out.get() >= 0, "Failed to open output file %s", outputFile.c_str());
+  ILO_ASSERT(copyFileRange(in.get(), 0, out.get(), 0, static_cast<uint64_t>(inStat.st_size)),
+             "Failed to copy %s to %s", inputFile.c_str(), outputFile.c_str());
+#else
+  std::ifstream in(inputFile, std::ios::binary);
+  ILO_ASSERT(in.good(), "Failed to open input file %s", inputFile.c_str());
+  std::ofstream out(outputFile, std::ios::binary | std::ios::trunc);
+  ILO_ASSERT(out.good(), "Failed to open output file %s", outputFile.c_str());
+  out << in.rdbuf();
+  ILO_ASSERT(out.good(), "Failed to copy %s to %s", inputFile.c_str(), outputFile.c_str());
+#endif
+}
+
+bool mmt::au2mhasconverterlib::dropFileFromCache(const std::string& filePath, bool writeBack) {
+#if defined(__linux__)
+  CFileDescriptor fd(open(filePath.c_str(), writeBack ? O_WRONLY : O_RDONLY));
+  if (fd.get() < 0) {
+    return false;
+  }
+  if (writeBack && fdatasync(fd.get()) != 0) {
+    return false;
+  }
+  return posix_fadvise(fd.get(), 0, 0, POSIX_FADV_DONTNEED) == 0;
+#else
+  (void)filePath;
+  (void)writeBack;
+  return false;
+#endif
+}
+
+bool mmt::au2mhasconverterlib::readMp4BoxHeader(int fd, uint64_t fileSize, uint64_t offset,
+                                                SMp4BoxHeader& box) {
+#if defined(__unix__) || defined(__APPLE__)
+  if (offset > fileSize || fileSize - offset < 8) {
+    return false;
+  }
+  uint8_t header[16];
+  const ssize_t headerBytes = pread(fd, header, sizeof(header), static_cast<off_t>(offset));
+  if (headerBytes < 8) {
+    return false;
+  }
+  uint64_t boxSize = (static_cast<uint64_t>(header[0]) << 24) | (header[1] << 16) |
+                     (header[2] << 8) | header[3];
+  box.headerSize = 8;
+  if (boxSize == 1) {
+    if (headerBytes < 16) {
+      return false;
+    }
+    boxSize = 0;
+    for (size_t i = 8; i < 16; ++i) {
+      boxSize = (boxSize << 8) | header[i];
+    }
+    box.headerSize = 16;
+  } else if (boxSize == 0) {
+    boxSize = fileSize - offset;
+  }
+  if (boxSize < box.headerSize || boxSize > fileSize - offset) {
+    return false;
+  }
+  std::memcpy(box.type, header + 4, sizeof(box.type));
+  box.offset = offset;
+  box.size = boxSize;
+  return true;
+#else
+  (void)fd;
+  (void)fileSize;
+  (void)offset;
+  (void)box;
+  return false;
+#endif
+}
+
+bool mmt::au2mhasconverterlib::prefetchMp4Head(const std::string& filePath, uint64_t mdatBytes) {
+#if defined(__linux__)
+  CFileDescriptor fd(open(filePath.c_str(), O_RDONLY));
+  struct stat fileStat;
+  if (fd.get() < 0 || fstat(fd.get(), &fileStat) != 0) {
+    return false;
+  }
+  const auto fileSize = static_cast<uint64_t>(fileStat.st_size);
+
+  uint64_t offset = 0;
+  SMp4BoxHeader box;
+  while (fileSize - offset >= 8) {
+    if (!readMp4BoxHeader(fd.get(), fileSize, offset, box)) {
+      return false;
+    }
+    const bool isMdat = std::memcmp(box.type, "mdat", 4) == 0;
+    const uint64_t length = isMdat ? std::min(box.size, box.headerSize + mdatBytes) : box.size;
+    (void)posix_fadvise(fd.get(), static_cast<off_t>(offset), static_cast<off_t>(length),
+                        POSIX_FADV_WILLNEED);
+    offset += box.size;
+  }
+  return true;
+#else
+  (void)filePath;
+  (void)mdatBytes;
+  return false;
+#endif
+}
+
+CWriteBehind::CWriteBehind(const std::string& filePath) {
+#if defined(__linux__)
+  m_fd = open(filePath.c_str(), O_RDONLY);
+#else
+  (void)filePath;
+#endif
+}
+
+CWriteBehind::~CWriteBehind() {
+#if defined(__linux__)
+  if (m_fd >= 0) {
+    if (fdatasync(m_fd) == 0) {
+      (void)posix_fadvise(m_fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+    close(m_fd);
+  }
+#endif
+}
+
+void CWriteBehind::update() {
+#if defined(__linux__)
+  struct stat fileStat;
+  if (m_fd < 0 || fstat(m_fd, &fileStat) != 0) {
+    return;
+  }
+  const auto size = static_cast<uint64_t>(fileStat.st_size);
+  if (size <= m_writeBackStarted) {
+    return;
+  }
+
+  // wait for the previous range, which had time to be written back since the last call
+  if (m_writeBackStarted > m_dropped) {
+    const auto offset = static_cast<off_t>(m_dropped);
+    const auto length = static_cast<off_t>(m_writeBackStarted - m_dropped);
+    if (sync_file_range(m_fd, offset, length,
+                        SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE |
+                            SYNC_FILE_RANGE_WAIT_AFTER) == 0) {
+      (void)posix_fadvise(m_fd, offset, length, POSIX_FADV_DONTNEED);
+    }
+    m_dropped = m_writeBackStarted;
+  }
+
+  (void)sync_file_range(m_fd, static_cast<off_t>(m_writeBackStarted),
+                        static_cast<off_t>(size - m_writeBackStarted), SYNC_FILE_RANGE_WRITE);
+  m_writeBackStarted = size;
+#endif
+}
+
+CMappedFile::CMappedFile(const std::string& filePath) {
+#if defined(__unix__) || defined(__APPLE__)
+  CFileDescriptor fd(open(filePath.c_str(), O_RDONLY));
+  struct stat fileStat;
+  if (fd.get() < 0 || fstat(fd.get(), &fileStat) != 0 || fileStat.st_size <= 0) {
+    return;
+  }
+  // e.g. files of 4 GiB or more on 32-bit targets
+  if (static_cast<uint64_t>(fileStat.st_size) > std::numeric_limits<size_t>::max()) {
+    AU2MHAS_LOG_INFO("%s is too large to be mapped", filePath.c_str());
+    return;
+  }
+  const auto size = static_cast<size_t>(fileStat.st_size);
+  // note: the mapping stays valid after closing the file descriptor
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+  if (mapping == MAP_FAILED) {
+    return;
+  }
+  // the hints are best effort, failing to apply them is no error
+  (void)madvise(mapping, size, MADV_SEQUENTIAL);
+#if defined(MADV_HUGEPAGE)
+  (void)madvise(mapping, size, MADV_HUGEPAGE);
+#endif
+  m_data = static_cast<const uint8_t*>(mapping);
+  m_size = size;
+#else
+  (void)filePath;
+#endif
+}
+
+CMappedFile::~CMappedFile() {
+#if defined(__unix__) || defined(__APPLE__)
+  if (m_data) {
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+  }
+#endif
+}
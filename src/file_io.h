@@ -0,0 +1,202 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/**
+ * @file file_io.h
+ *
+ * @brief Low level file helpers bypassing the buffered ISOBMFF input and output.
+ */
+#pragma once
+
+// System includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Internal includes
+#include "mmtau2mhasconverterlib/version.h"
+
+namespace mmt {
+namespace au2mhasconverterlib {
+/*!
+ * @brief Copies @p length bytes at @p inOffset of @p inFd to @p outOffset of @p outFd.
+ *
+ * Uses copy_file_range on Linux, so the bytes are copied in the kernel (or the file system shares
+ * the extents). Falls back to pread / pwrite if the kernel or the file systems don't support it.
+ * Returns false on I/O errors or a premature end of the input file, and if the platform has no
+ * positional file I/O.
+ */
+bool copyFileRange(int inFd, uint64_t inOffset, int outFd, uint64_t outOffset, uint64_t length);
+
+//! Copies the file @p inputFile to @p outputFile (replacing it) with copyFileRange().
+void copyFile(const std::string& inputFile, const std::string& outputFile);
+
+/*!
+ * @brief Drops the pages of @p filePath from the page cache.
+ *
+ * Dirty pages can't be dropped, so set @p writeBack for files written before (outputs) to write
+ * them back first. Inputs don't need it. Returns false if the platform doesn't support it.
+ */
+bool dropFileFromCache(const std::string& filePath, bool writeBack);
+
+//! Position of a top level box of a MP4 file.
+struct SMp4BoxHeader {
+  //! The four character code of the box.
+  char type[4] = {};
+  uint64_t offset = 0;
+  uint64_t headerSize = 0;
+  uint64_t size = 0;
+};
+
+/*!
+ * @brief Reads the header of the top level box at @p offset of the MP4 file @p fd, which is
+ * @p fileSize bytes long.
+ *
+ * Returns false for read errors, malformed boxes and if the platform has no positional file I/O.
+ */
+bool readMp4BoxHeader(int fd, uint64_t fileSize, uint64_t offset, SMp4BoxHeader& box);
+
+/*!
+ * @brief Asks the kernel to read the metadata and the first sample data of the MP4 file
+ * @p filePath into the page cache in the background.
+ *
+ * Walks the top level boxes and advises WILLNEED for every box except 'mdat', plus the first
+ * @p mdatBytes bytes of the 'mdat' payload. Returns false if the file can't be read or the
+ * platform doesn't support it.
+ */
+bool prefetchMp4Head(const std::string& filePath, uint64_t mdatBytes);
+
+/*!
+ * @brief Writes back a file while another component writes it, dropping the written pages from the
+ * page cache, so writing a large file doesn't evict the working set of other processes.
+ *
+ * Does nothing if the file can't be opened or the platform doesn't support it.
+ */
+class CWriteBehind {
+ public:
+  explicit CWriteBehind(const std::string& filePath);
+  //! Writes back and drops the remaining pages.
+  ~CWriteBehind();
+  CWriteBehind(const CWriteBehind&) = delete;
+  CWriteBehind& operator=(const CWriteBehind&) = delete;
+
+  /*!
+   * Starts the write-back of the data appended since the last call, and drops the data whose
+   * write-back was started by the previous call. To be called regularly while the file grows.
+   */
+  void update();
+
+ private:
+  int m_fd = -1;
+  uint64_t m_writeBackStarted = 0;
+  uint64_t m_dropped = 0;
+};
+
+/*!
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * The mapping is advised for sequential access (and huge pages where supported), so the kernel
+ * reads ahead and the bytes can be processed in place without copying them into a buffer.
+ */
+class CMappedFile {
+ public:
+  /*!
+   * @brief Maps @p filePath.
+   *
+   * isValid() is false if that fails, the file exceeds the address space (e.g. 4 GiB or more on
+   * 32-bit targets) or the platform doesn't support it.
+   */
+  explicit CMappedFile(const std::string& filePath);
+  ~CMappedFile();
+  CMappedFile(const CMappedFile&) = delete;
+  CMappedFile& operator=(const CMappedFile&) = delete;
+
+  bool isValid() const { return m_data != nullptr; }
+  const uint8_t* data() const { return m_data; }
+  size_t size() const { return m_size; }
+
+ private:
+  const uint8_t* m_data = nullptr;
+  size_t m_size = 0;
+};
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
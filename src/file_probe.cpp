@@ -0,0 +1,276 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// System includes
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// External includes
+#include "ilo/bitparser.h"
+#include "mmtisobmff/types.h"
+#include "mmtmhasparserlib/mhasconfigpacket.h"
+#include "mmtmhasparserlib/mhasparser.h"
+
+// Internal includes
+#include "mmtau2mhasconverterlib/file_probe.h"
+#include "audio_preroll.h"
+#include "converter_helpers.h"
+#include "logging.h"
+#include "mhas_scan.h"
+
+using namespace mmt::au2mhasconverterlib;
+
+bool SFileProbeReport::isConvertible() const {
+  if (truncatedIpfs != 0) {
+    return false;
+  }
+  if (hasFileConfig && fileConfig.status != EConversionStatus::OK) {
+    return false;
+  }
+  return std::all_of(inBandConfigs.begin(), inBandConfigs.end(), [](const SConfigValidation& c) {
+    return c.status == EConversionStatus::OK;
+  });
+}
+
+//! Collects the config related parts of the report while walking the samples.
+class CConfigTracker {
+ public:
+  explicit CConfigTracker(SFileProbeReport& report) : m_report(report) {}
+
+  void setFileConfig(const ilo::ByteBuffer& config) {
+    m_report.hasFileConfig = true;
+    CConverter::validateConfig(config, m_report.fileConfig);
+    m_seenConfigs.push_back(config);
+    m_currentConfig = config;
+  }
+
+  void addInBandConfig(const ilo::ByteBuffer& config) {
+    if (!m_currentConfig.empty() && m_currentConfig != config) {
+      ++m_report.configChanges;
+    }
+    m_currentConfig = config;
+
+    if (std::find(m_seenConfigs.begin(), m_seenConfigs.end(), config) == m_seenConfigs.end()) {
+      m_seenConfigs.push_back(config);
+      m_report.inBandConfigs.emplace_back();
+      CConverter::validateConfig(config, m_report.inBandConfigs.back());
+    }
+  }
+
+  void addRandomAccessSample(uint64_t sampleIndex) {
+    if (m_report.ipfs == 0) {
+      m_report.firstIpf = sampleIndex;
+    } else {
+      uint64_t distance = sampleIndex - m_lastIpf;
+      if (m_report.minIpfDistance == 0 || distance < m_report.minIpfDistance) {
+        m_report.minIpfDistance = distance;
+      }
+      m_report.maxIpfDistance = std::max(m_report.maxIpfDistance, distance);
+    }
+    m_lastIpf = sampleIndex;
+    ++m_report.ipfs;
+  }
+
+ private:
+  SFileProbeReport& m_report;
+  std::vector<ilo::ByteBuffer> m_seenConfigs;
+  ilo::ByteBuffer m_currentConfig;
+  uint64_t m_lastIpf = 0;
+};
+
+/*!
+ * Adds the config packets of the MHM sample @p rawData to @p configs, returns true if there is one.
+ *
+ * @p packets and @p config are scratch space.
+ */
+static bool findMhasConfigs(const ilo::ByteBuffer& rawData, std::vector<SMhasPacketHeader>& packets,
+                            ilo::ByteBuffer& config, CConfigTracker& configs) {
+  const auto configType =
+      static_cast<uint32_t>(mmt::mhasparserlib::EMhasPacketType::PACTYP_MPEGH3DACFG);
+  bool hasConfig = false;
+  if (scanMhasPackets(rawData.data(), rawData.size(), packets)) {
+    for (const auto& packet : packets) {
+      if (packet.type == configType) {
+        hasConfig = true;
+        config.assign(rawData.begin() + packet.payloadOffset(), rawData.begin() + packet.end());
+        configs.addInBandConfig(config);
+      }
+    }
+    return hasConfig;
+  }
+
+  // not a sequence of complete packets, let the parser handle it
+  mmt::mhasparserlib::CMhasParser mhasParser;
+  // note: we need to call sync on the mhas parser otherwise it won't return packets
+  mhasParser.sync();
+  mhasParser.feed(rawData);
+  mhasParser.parsePackets();
+  while (mmt::mhasparserlib::CUniqueMhasPacket mhasPacket = mhasParser.nextPacket()) {
+    if (mmt::mhasparserlib::EMhasPacketType(mhasPacket->packetType()) ==
+        mmt::mhasparserlib::EMhasPacketType::PACTYP_MPEGH3DACFG) {
+      const auto* configPacket =
+          dynamic_cast<mmt::mhasparserlib::CMhasConfigPacket*>(mhasPacket.get());
+      hasConfig = true;
+      configs.addInBandConfig(configPacket->payload());
+    }
+  }
+  return hasConfig;
+}
+
+static SFileProbeReport& finishReport(SFileProbeReport& report) {
+  if (report.ipfs == 0) {
+    report.firstIpf = report.samples;
+  }
+  return report;
+}
+
+CFileProbe::CFileProbe(const SConfig& config) : m_config(config) {}
+
+SFileProbeReport CFileProbe::probe() {
+  m_config.logCallback("Start probing " + m_config.inputFile);
+
+  std::unique_ptr<mmt::isobmff::CIsobmffReader> reader;
+  std::unique_ptr<mmt::isobmff::CMpeghTrackReader> trackReader;
+  openReader(m_config.inputFile, reader, trackReader);
+  mmt::isobmff::Codec codec = reader->trackInfos()[0].codec;
+  ILO_ASSERT(codec == mmt::isobmff::Codec::mpegh_mha || codec == mmt::isobmff::Codec::mpegh_mhm,
+             "Codec of first track is neither mha nor  mhm");
+
+  SFileProbeReport report;
+  report.isMhm = codec == mmt::isobmff::Codec::mpegh_mhm;
+  CConfigTracker configs(report);
+  if (auto mhaDcr = trackReader->mhaDecoderConfigRecord()) {
+    configs.setFileConfig(mhaDcr->mpegh3daConfig());
+  }
+
+  const uint64_t totalSamples = reader->trackInfos()[0].sampleCount;
+  uint64_t samplesToInspect = totalSamples;
+  if (m_config.maxSamples != 0 && (totalSamples == 0 || m_config.maxSamples < totalSamples)) {
+    samplesToInspect = m_config.maxSamples;
+  }
+  ilo::ByteBuffer inBandConfig;
+  std::vector<SMhasPacketHeader> packets;
+  SAudioPreRollHeader preRoll;
+  mmt::isobmff::CSample sample;
+  trackReader->nextSample(sample);
+  while (!sample.empty()) {
+    if (!report.isMhm) {
+      if (startsWithAudioPreRoll(sample.rawData)) {
+        if (!audioPreRollFitsInFrame(sample.rawData)) {
+          // note: the conversion rejects it as invalid bitstream
+          if (report.truncatedIpfs++ == 0) {
+            report.firstTruncatedIpf = report.samples;
+          }
+        } else {
+          configs.addRandomAccessSample(report.samples);
+          ilo::CBitParser parser(sample.rawData);
+          readAudioPreRollHeader(parser, preRoll);
+          if (!preRoll.config.empty()) {
+            configs.addInBandConfig(preRoll.config);
+          }
+        }
+      }
+    } else if (findMhasConfigs(sample.rawData, packets, inBandConfig, configs)) {
+      configs.addRandomAccessSample(report.samples);
+    }
+
+    ++report.samples;
+    if (m_config.interruptCallback()) {
+      return finishReport(report);
+    }
+    if (samplesToInspect != 0) {
+      uint64_t progress = (report.samples * 100) / samplesToInspect;
+      if (progress <= 100) {
+        m_config.progressCallback(static_cast<uint16_t>(progress));
+      }
+    }
+    if (report.samples == samplesToInspect && samplesToInspect != totalSamples) {
+      // limited by maxSamples
+      return finishReport(report);
+    }
+    trackReader->nextSample(sample);
+  }
+
+  report.complete = true;
+  return finishReport(report);
+}
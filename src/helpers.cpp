@@ -83,6 +83,7 @@ amm-info@iis.fraunhofer.de
 // System includes
 #include <algorithm>
 #include <cctype>
+#include <cstdio>
 
 // Internal includes
 #include "helpers.h"
@@ -140,5 +141,39 @@ bool endsWithIgnoreCase(const std::string& inString, const std::string& endStrin
 size_t countOccurences(const std::string& inString, char token) {
   return static_cast<std::size_t>(std::count(inString.begin(), inString.end(), token));
 }
+
+std::string escapeJsonString(const std::string& inString) {
+  std::string out;
+  out.reserve(inString.size());
+  for (char c : inString) {
+    switch (c) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      case '\r':
+        out += "\\r";
+        break;
+      case '\t':
+        out += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+          out += escaped;
+        } else {
+          out += c;
+        }
+        break;
+    }
+  }
+  return out;
+}
 }  // namespace au2mhasconverterlib
 }  // namespace mmt
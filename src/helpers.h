@@ -97,5 +97,6 @@ std::string replaceInString(const std::string& inString, char searchFor, char re
 bool endsWith(const std::string& inString, const std::string& endString);
 bool endsWithIgnoreCase(const std::string& inString, const std::string& endString);
 size_t countOccurences(const std::string& inString, char token);
+std::string escapeJsonString(const std::string& inString);
 }  // namespace au2mhasconverterlib
 }  // namespace mmt
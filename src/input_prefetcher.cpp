@@ -0,0 +1,282 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// System includes
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(MMTAU2MHAS_WITH_LIBURING)
+#include <liburing.h>
+#include <sys/uio.h>
+#endif
+
+// Internal includes
+#include "file_io.h"
+#include "input_prefetcher.h"
+
+using namespace mmt::au2mhasconverterlib;
+
+CInputPrefetcher::CInputPrefetcher(const std::string& inputFile, uint32_t queueDepth,
+                                   size_t chunkSize)
+    : m_chunkSize(chunkSize), m_window(static_cast<uint64_t>(queueDepth) * chunkSize) {
+#if defined(__unix__) || defined(__APPLE__)
+  m_fd = open(inputFile.c_str(), O_RDONLY);
+  struct stat fileStat;
+  if (m_fd < 0 || fstat(m_fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+    return;
+  }
+  m_size = static_cast<uint64_t>(fileStat.st_size);
+
+  // note: without a 'mdat' box, the read position starts at the beginning of the file
+  SMp4BoxHeader box;
+  for (uint64_t offset = 0; readMp4BoxHeader(m_fd, m_size, offset, box); offset += box.size) {
+    if (std::memcmp(box.type, "mdat", 4) == 0) {
+      m_dataOffset = box.offset + box.headerSize;
+      break;
+    }
+  }
+  m_readPosition = m_dataOffset;
+
+#if defined(MMTAU2MHAS_WITH_LIBURING)
+  if (queueDepth > 0 && chunkSize > 0) {
+    m_thread =
+        std::thread([this, queueDepth, chunkSize]() { readWithUring(queueDepth, chunkSize); });
+    return;
+  }
+#else
+  (void)queueDepth;
+#endif
+  m_advise = true;
+  adviseWillNeed(readLimit());
+#else
+  (void)inputFile;
+  (void)queueDepth;
+#endif
+}
+
+CInputPrefetcher::~CInputPrefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_condition.notify_one();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+#if defined(__unix__) || defined(__APPLE__)
+  if (m_fd >= 0) {
+    close(m_fd);
+  }
+#endif
+}
+
+void CInputPrefetcher::setConsumedSampleBytes(uint64_t bytes) {
+  const uint64_t position = m_dataOffset + bytes;
+  if (m_fd < 0 || position <= m_readPosition.load(std::memory_order_relaxed)) {
+    return;
+  }
+  m_readPosition = position;
+  // note: pairs with the flag being set before the prefetch thread checks the read limit
+  if (m_waiting) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_condition.notify_one();
+  }
+
+  // Advise in steps of whole chunks, not per sample
+  const uint64_t limit = readLimit();
+  if (m_advise.load(std::memory_order_relaxed) && limit > m_advisedEnd &&
+      (limit == m_size || limit - m_advisedEnd >= m_chunkSize)) {
+    adviseWillNeed(limit);
+  }
+}
+
+uint64_t CInputPrefetcher::readLimit() const {
+  return std::min(m_size, m_readPosition.load() + m_window);
+}
+
+void CInputPrefetcher::adviseWillNeed(uint64_t end) {
+#if defined(__linux__)
+  if (end > m_advisedEnd) {
+    (void)posix_fadvise(m_fd, static_cast<off_t>(m_advisedEnd),
+                        static_cast<off_t>(end - m_advisedEnd), POSIX_FADV_WILLNEED);
+  }
+#endif
+  m_advisedEnd = end;
+}
+
+void CInputPrefetcher::waitForReader(uint64_t end) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_waiting = true;
+  m_condition.wait(lock, [&] { return m_stop || readLimit() >= end; });
+  m_waiting = false;
+}
+
+void CInputPrefetcher::readWithUring(uint32_t queueDepth, size_t chunkSize) {
+#if defined(MMTAU2MHAS_WITH_LIBURING)
+  struct io_uring ring;
+  if (io_uring_queue_init(queueDepth, &ring, 0) < 0) {
+    // e.g. io_uring disabled by the kernel or a seccomp policy, the converting thread advises the
+    // window from its next read on
+    m_advise = true;
+    return;
+  }
+
+  std::vector<std::vector<uint8_t>> buffers(queueDepth, std::vector<uint8_t>(chunkSize));
+  std::vector<struct iovec> iovecs(queueDepth);
+  for (uint32_t i = 0; i < queueDepth; ++i) {
+    iovecs[i].iov_base = buffers[i].data();
+    iovecs[i].iov_len = chunkSize;
+  }
+  // registered buffers save the page pinning per read, plain reads work without them
+  const bool registered = io_uring_register_buffers(&ring, iovecs.data(), queueDepth) == 0;
+
+  std::vector<uint32_t> freeBuffers;
+  for (uint32_t i = 0; i < queueDepth; ++i) {
+    freeBuffers.push_back(queueDepth - 1 - i);
+  }
+  uint64_t nextOffset = 0;
+  uint32_t inFlight = 0;
+  bool failed = false;
+  while (!m_stop && !failed) {
+    const uint64_t limit = readLimit();
+    while (!freeBuffers.empty() && nextOffset < limit) {
+      const auto length = static_cast<unsigned>(std::min<uint64_t>(chunkSize, m_size - nextOffset));
+      if (limit - nextOffset < length) {
+        break;  // wait for the reader to make room for a whole chunk
+      }
+      struct io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+      if (!sqe) {
+        break;
+      }
+      const uint32_t index = freeBuffers.back();
+      freeBuffers.pop_back();
+      if (registered) {
+        io_uring_prep_read_fixed(sqe, m_fd, buffers[index].data(), length, nextOffset,
+                                 static_cast<int>(index));
+      } else {
+        io_uring_prep_read(sqe, m_fd, buffers[index].data(), length, nextOffset);
+      }
+      io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(static_cast<uintptr_t>(index)));
+      nextOffset += length;
+      ++inFlight;
+    }
+    if (inFlight == 0) {
+      if (nextOffset >= m_size) {
+        break;  // the whole file was read
+      }
+      waitForReader(std::min<uint64_t>(m_size, nextOffset + chunkSize));
+      continue;
+    }
+
+    io_uring_submit(&ring);
+    struct io_uring_cqe* cqe = nullptr;
+    if (io_uring_wait_cqe(&ring, &cqe) < 0) {
+      break;
+    }
+    failed = cqe->res < 0;
+    freeBuffers.push_back(static_cast<uint32_t>(
+        reinterpret_cast<uintptr_t>(io_uring_cqe_get_data(cqe))));
+    io_uring_cqe_seen(&ring, cqe);
+    --inFlight;
+  }
+
+  // the buffers must outlive the reads still in flight
+  while (inFlight > 0) {
+    struct io_uring_cqe* cqe = nullptr;
+    if (io_uring_wait_cqe(&ring, &cqe) < 0) {
+      break;
+    }
+    io_uring_cqe_seen(&ring, cqe);
+    --inFlight;
+  }
+  io_uring_queue_exit(&ring);
+#else
+  (void)queueDepth;
+  (void)chunkSize;
+#endif
+}
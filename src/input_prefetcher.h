@@ -0,0 +1,157 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/**
+ * @file input_prefetcher.h
+ *
+ * @brief Background read-ahead of an input file into the page cache.
+ */
+#pragma once
+
+// System includes
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Internal includes
+#include "mmtau2mhasconverterlib/version.h"
+
+namespace mmt {
+namespace au2mhasconverterlib {
+/*!
+ * @brief Reads an input file ahead of the converter, so its buffered sample reads hit the page
+ * cache.
+ *
+ * The read-ahead is bounded to queueDepth * chunkSize bytes beyond the read position of the
+ * converter, see setConsumedSampleBytes(). With liburing (MMTAU2MHAS_WITH_LIBURING), a background
+ * thread keeps up to queueDepth reads of chunkSize bytes in flight through io_uring, reading into
+ * registered buffers whose content is discarded. Otherwise, or if io_uring is not available at
+ * runtime, the kernel is only asked to read ahead that window (posix_fadvise WILLNEED).
+ * Prefetching is best effort, errors are ignored.
+ */
+class CInputPrefetcher {
+ public:
+  CInputPrefetcher(const std::string& inputFile, uint32_t queueDepth, size_t chunkSize);
+  //! Stops the prefetching (cancels no reads already in flight, but waits for them).
+  ~CInputPrefetcher();
+  CInputPrefetcher(const CInputPrefetcher&) = delete;
+  CInputPrefetcher& operator=(const CInputPrefetcher&) = delete;
+
+  /*!
+   * @brief Reports the number of sample bytes the converter has read so far.
+   *
+   * The sample data is assumed to be stored in order from the payload of the first 'mdat' box on,
+   * so the read position is the payload offset plus @p bytes. Smaller values than reported before
+   * (e.g. the samples are read once more) don't move the read position back.
+   */
+  void setConsumedSampleBytes(uint64_t bytes);
+
+ private:
+  uint64_t readLimit() const;
+  void adviseWillNeed(uint64_t end);
+  //! Blocks until the read limit reached @p end or the prefetching is stopped.
+  void waitForReader(uint64_t end);
+  void readWithUring(uint32_t queueDepth, size_t chunkSize);
+
+  int m_fd = -1;
+  uint64_t m_size = 0;
+  //! Payload offset of the first 'mdat' box, where the read position starts.
+  uint64_t m_dataOffset = 0;
+  size_t m_chunkSize = 0;
+  uint64_t m_window = 0;
+  //! End of the range advised so far (without io_uring, only used by the converting thread).
+  uint64_t m_advisedEnd = 0;
+  //! Whether the window is advised instead of being read through io_uring.
+  std::atomic<bool> m_advise{false};
+  std::atomic<uint64_t> m_readPosition{0};
+  std::atomic<bool> m_waiting{false};
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::atomic<bool> m_stop{false};
+  std::thread m_thread;
+};
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
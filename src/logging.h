@@ -82,5 +82,89 @@ amm-info@iis.fraunhofer.de
 
 #pragma once
 
+// System includes
+#include <cstdint>
+
+// External includes
 #define LOG_COMPONENT "au2mhas"
 #include "ilo/logging.h"
+
+// Internal includes
+#include "mmtau2mhasconverterlib/version.h"
+
+// Log levels for the compile-time filter MMTAU2MHAS_MIN_LOG_LEVEL
+#define AU2MHAS_LOG_LEVEL_INFO 0
+#define AU2MHAS_LOG_LEVEL_WARNING 1
+#define AU2MHAS_LOG_LEVEL_NONE 2
+
+#ifndef MMTAU2MHAS_MIN_LOG_LEVEL
+#define MMTAU2MHAS_MIN_LOG_LEVEL AU2MHAS_LOG_LEVEL_INFO
+#endif
+
+namespace mmt {
+namespace au2mhasconverterlib {
+class CAsyncLogSink;
+
+namespace logging {
+/*!
+ * @brief Passes a printf-style message to the log sink installed for the calling thread.
+ *
+ * The message is formatted directly into the ring buffer of the sink, @p prefix is prepended.
+ * Returns false (without formatting) if no sink is installed, see CThreadLogSinkScope.
+ */
+bool logToThreadSink(const char* prefix, const char* format, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+/*!
+ * @brief Routes the internal log messages of the calling thread to an asynchronous log sink.
+ *
+ * While the scope exists, the AU2MHAS_LOG_* messages of the thread are enqueued in @p sink and
+ * tagged with @p jobId instead of being written by the internal logging. Scopes can be nested.
+ */
+class CThreadLogSinkScope {
+ public:
+  CThreadLogSinkScope(CAsyncLogSink* sink, uint64_t jobId);
+  ~CThreadLogSinkScope();
+
+  CThreadLogSinkScope(const CThreadLogSinkScope&) = delete;
+  CThreadLogSinkScope& operator=(const CThreadLogSinkScope&) = delete;
+
+ private:
+  CAsyncLogSink* m_previousSink;
+  uint64_t m_previousJobId;
+};
+}  // namespace logging
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
+
+// Log calls below the configured level are removed entirely, including the evaluation of their
+// arguments. Use these macros instead of ILO_LOG_* within the library. Calls on threads with an
+// installed log sink (see CThreadLogSinkScope) never write to the internal logging themselves.
+#if MMTAU2MHAS_MIN_LOG_LEVEL <= AU2MHAS_LOG_LEVEL_INFO
+#define AU2MHAS_LOG_INFO(...)                                                          \
+  do {                                                                                 \
+    if (!::mmt::au2mhasconverterlib::logging::logToThreadSink("", __VA_ARGS__)) {      \
+      ILO_LOG_INFO(__VA_ARGS__);                                                       \
+    }                                                                                  \
+  } while (0)
+#else
+#define AU2MHAS_LOG_INFO(...) \
+  do {                        \
+  } while (0)
+#endif
+
+#if MMTAU2MHAS_MIN_LOG_LEVEL <= AU2MHAS_LOG_LEVEL_WARNING
+#define AU2MHAS_LOG_WARNING(...)                                                         \
+  do {                                                                                   \
+    if (!::mmt::au2mhasconverterlib::logging::logToThreadSink("WARN: ", __VA_ARGS__)) { \
+      ILO_LOG_WARNING(__VA_ARGS__);                                                      \
+    }                                                                                    \
+  } while (0)
+#else
+#define AU2MHAS_LOG_WARNING(...) \
+  do {                           \
+  } while (0)
+#endif
@@ -0,0 +1,210 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// Internal includes
+#include "mhas_scan.h"
+
+using namespace mmt::au2mhasconverterlib;
+
+namespace {
+//! Minimal MSB-first bit reader for the packet headers, all reads are bounds checked.
+class CHeaderBitReader {
+ public:
+  CHeaderBitReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+  bool read(uint32_t numBits, uint64_t& value) {
+    if (numBits > (m_size - m_byte) * 8 - m_bit) {
+      return false;
+    }
+    value = 0;
+    while (numBits > 0) {
+      const uint32_t available = 8 - m_bit;
+      const uint32_t count = numBits < available ? numBits : available;
+      const uint32_t bits = (m_data[m_byte] >> (available - count)) & ((1u << count) - 1u);
+      value = (value << count) | bits;
+      numBits -= count;
+      m_bit += count;
+      if (m_bit == 8) {
+        m_bit = 0;
+        ++m_byte;
+      }
+    }
+    return true;
+  }
+
+  //! Same syntax as mmt::mhasparserlib::readEscapedValue.
+  bool readEscaped(uint32_t numBits1, uint32_t numBits2, uint32_t numBits3, uint64_t& value) {
+    if (!read(numBits1, value)) {
+      return false;
+    }
+    uint64_t escapeValue = 0;
+    if (value == (uint64_t{1} << numBits1) - 1) {
+      if (!read(numBits2, escapeValue)) {
+        return false;
+      }
+      value += escapeValue;
+      if (escapeValue == (uint64_t{1} << numBits2) - 1) {
+        if (!read(numBits3, escapeValue)) {
+          return false;
+        }
+        value += escapeValue;
+      }
+    }
+    return true;
+  }
+
+  size_t bytePosition() const { return m_byte; }
+  bool isByteAligned() const { return m_bit == 0; }
+
+  //! Continues reading at byte @p position (must not exceed the size).
+  void seekByte(size_t position) {
+    m_byte = position;
+    m_bit = 0;
+  }
+
+ private:
+  const uint8_t* m_data;
+  size_t m_size;
+  size_t m_byte = 0;
+  uint32_t m_bit = 0;
+};
+
+/*!
+ * Decodes the header at @p data if none of its fields is escaped, which is the case for all packets
+ * shorter than 2047 bytes with a type below 7 and a label below 3. The header is 2 bytes then.
+ */
+inline bool readShortHeader(const uint8_t* data, SMhasPacketHeader& header) {
+  const uint32_t bits = (static_cast<uint32_t>(data[0]) << 8) | data[1];
+  const uint32_t type = bits >> 13;
+  const uint32_t label = (bits >> 11) & 0x3u;
+  const uint32_t length = bits & 0x7FFu;
+  if (type == 0x7u || label == 0x3u || length == 0x7FFu) {
+    return false;
+  }
+  header.type = type;
+  header.label = label;
+  header.headerSize = 2;
+  header.payloadSize = length;
+  return true;
+}
+}  // namespace
+
+bool mmt::au2mhasconverterlib::readMhasPacketHeader(const uint8_t* data, size_t size,
+                                                    size_t offset, SMhasPacketHeader& header) {
+  if (offset >= size) {
+    return false;
+  }
+  header.offset = offset;
+  if (size - offset >= 2 && readShortHeader(data + offset, header)) {
+    return header.payloadSize <= size - header.payloadOffset();
+  }
+
+  CHeaderBitReader reader(data, size);
+  reader.seekByte(offset);
+  uint64_t type = 0;
+  uint64_t length = 0;
+  if (!reader.readEscaped(3, 8, 8, type) || !reader.readEscaped(2, 8, 32, header.label) ||
+      !reader.readEscaped(11, 24, 24, length)) {
+    return false;
+  }
+  // note: all escape extensions are multiples of 8 bits, so the header is always byte aligned
+  if (!reader.isByteAligned() || length > size - reader.bytePosition()) {
+    return false;
+  }
+  header.type = static_cast<uint32_t>(type);
+  header.headerSize = reader.bytePosition() - offset;
+  header.payloadSize = static_cast<size_t>(length);
+  return true;
+}
+
+bool mmt::au2mhasconverterlib::scanMhasPackets(const uint8_t* data, size_t size,
+                                               std::vector<SMhasPacketHeader>& packets) {
+  packets.clear();
+  SMhasPacketHeader header;
+  for (size_t offset = 0; offset < size; offset = header.end()) {
+    if (!readMhasPacketHeader(data, size, offset, header)) {
+      return false;
+    }
+    packets.push_back(header);
+  }
+  return true;
+}
@@ -0,0 +1,250 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+// System includes
+#include <cinttypes>
+#include <cstdio>
+#include <utility>
+
+// Internal includes
+#include "helpers.h"
+#include "logging.h"
+#include "trace_recorder.h"
+
+namespace mmt {
+namespace au2mhasconverterlib {
+constexpr size_t CTraceRecorder::MAX_ARGS;
+constexpr size_t CTraceRecorder::FLUSH_EVENTS;
+
+//! Formats nanoseconds as the microseconds expected by the trace-event format.
+static std::string toMicroseconds(uint64_t nanoseconds) {
+  char formatted[32];
+  std::snprintf(formatted, sizeof(formatted), "%" PRIu64 ".%03u", nanoseconds / 1000,
+                static_cast<unsigned>(nanoseconds % 1000));
+  return formatted;
+}
+
+static void writeEvent(std::ostream& file, const CTraceRecorder::SEvent& event) {
+  file << "{\"name\": \"" << escapeJsonString(event.name) << "\", \"cat\": \"" << event.category
+       << "\", \"ph\": \"" << event.phase << "\", \"ts\": " << toMicroseconds(event.timestampNs);
+  if (event.phase == 'X') {
+    file << ", \"dur\": " << toMicroseconds(event.durationNs);
+  } else {
+    file << ", \"s\": \"t\"";
+  }
+  file << ", \"pid\": 1, \"tid\": " << event.threadIndex << ", \"args\": {";
+  for (size_t i = 0; i < event.numArgs; ++i) {
+    file << (i == 0 ? "" : ", ") << "\"" << event.argNames[i] << "\": " << event.argValues[i];
+  }
+  if (!event.detail.empty()) {
+    file << (event.numArgs == 0 ? "" : ", ") << "\"detail\": \"" << escapeJsonString(event.detail)
+         << "\"";
+  }
+  file << "}}";
+}
+
+CTraceRecorder::CTraceRecorder(const std::string& filePath)
+    : m_filePath(filePath),
+      m_start(std::chrono::steady_clock::now()),
+      m_file(filePath, std::ios::out | std::ios::trunc) {
+  if (!m_file.good()) {
+    AU2MHAS_LOG_WARNING("Opening trace file %s failed", m_filePath.c_str());
+    return;
+  }
+  m_events.reserve(FLUSH_EVENTS);
+  m_file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+}
+
+CTraceRecorder::~CTraceRecorder() {
+  try {
+    finish();
+  } catch (const std::exception& ex) {
+    AU2MHAS_LOG_WARNING("Writing trace file %s failed: %s", m_filePath.c_str(), ex.what());
+  }
+}
+
+uint64_t CTraceRecorder::now() const {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now() - m_start)
+                                   .count());
+}
+
+void CTraceRecorder::record(SEvent&& event) {
+  std::vector<SEvent> events;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto inserted = m_threadIndices.insert(
+        std::make_pair(std::this_thread::get_id(), static_cast<uint32_t>(m_threadIndices.size())));
+    event.threadIndex = inserted.first->second;
+    m_events.push_back(std::move(event));
+    if (m_events.size() < FLUSH_EVENTS) {
+      return;
+    }
+    events.swap(m_events);
+    m_events.reserve(FLUSH_EVENTS);
+  }
+  writeEvents(events);
+}
+
+void CTraceRecorder::instant(const char* name, const char* category, const char* argName,
+                             uint64_t argValue) {
+  SEvent event;
+  event.name = name;
+  event.category = category;
+  event.phase = 'i';
+  event.timestampNs = now();
+  if (argName != nullptr) {
+    event.argNames[0] = argName;
+    event.argValues[0] = argValue;
+    event.numArgs = 1;
+  }
+  record(std::move(event));
+}
+
+void CTraceRecorder::writeEvents(const std::vector<SEvent>& events) {
+  std::lock_guard<std::mutex> lock(m_fileMutex);
+  if (!m_file.is_open()) {
+    return;
+  }
+  for (const SEvent& event : events) {
+    m_file << (m_firstEntry ? "" : ",\n");
+    writeEvent(m_file, event);
+    m_firstEntry = false;
+  }
+}
+
+void CTraceRecorder::finish() {
+  std::vector<SEvent> events;
+  std::map<std::thread::id, uint32_t> threadIndices;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    events.swap(m_events);
+    threadIndices.swap(m_threadIndices);
+  }
+  writeEvents(events);
+
+  std::lock_guard<std::mutex> lock(m_fileMutex);
+  if (!m_file.is_open()) {
+    return;
+  }
+  for (const auto& thread : threadIndices) {
+    m_file << (m_firstEntry ? "" : ",\n");
+    m_file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread.second
+           << ", \"args\": {\"name\": \"thread " << thread.second << "\"}}";
+    m_firstEntry = false;
+  }
+  m_file << "\n]}\n";
+  m_file.close();
+  ILO_ASSERT(!m_file.fail(), "Writing trace file %s failed", m_filePath.c_str());
+}
+
+CTraceSpan::CTraceSpan(CTraceRecorder* recorder, const char* name, const char* category)
+    : m_recorder(recorder) {
+  if (m_recorder) {
+    m_event.name = name;
+    m_event.category = category;
+    m_event.timestampNs = m_recorder->now();
+  }
+}
+
+CTraceSpan::~CTraceSpan() {
+  if (m_recorder) {
+    m_event.durationNs = m_recorder->now() - m_event.timestampNs;
+    m_recorder->record(std::move(m_event));
+  }
+}
+
+void CTraceSpan::addArg(const char* name, uint64_t value) {
+  if (m_recorder && m_event.numArgs < CTraceRecorder::MAX_ARGS) {
+    m_event.argNames[m_event.numArgs] = name;
+    m_event.argValues[m_event.numArgs] = value;
+    ++m_event.numArgs;
+  }
+}
+
+void CTraceSpan::setDetail(const std::string& detail) {
+  if (m_recorder) {
+    m_event.detail = detail;
+  }
+}
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
@@ -0,0 +1,185 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+#pragma once
+
+// System includes
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Internal includes
+#include "mmtau2mhasconverterlib/version.h"
+
+namespace mmt {
+namespace au2mhasconverterlib {
+/*!
+ * @brief Thread-safe collector of timeline events written in the Chrome trace-event JSON format.
+ *
+ * The resulting file can be opened with chrome://tracing or https://ui.perfetto.dev. Events are
+ * written to the file in batches of FLUSH_EVENTS while recording, so the memory use does not grow
+ * with the length of the conversion. The file is completed when the recorder is destroyed.
+ */
+class CTraceRecorder {
+ public:
+  //! Maximum number of numeric arguments per event.
+  static constexpr size_t MAX_ARGS = 2;
+  //! Number of buffered events that are written to the file at once.
+  static constexpr size_t FLUSH_EVENTS = 1024;
+
+  struct SEvent {
+    std::string name;
+    const char* category = "";
+    //! Trace-event phase, 'X' for complete (span) events and 'i' for instant events.
+    char phase = 'X';
+    uint64_t timestampNs = 0;
+    uint64_t durationNs = 0;
+    uint32_t threadIndex = 0;
+    const char* argNames[MAX_ARGS] = {};
+    uint64_t argValues[MAX_ARGS] = {};
+    size_t numArgs = 0;
+    //! Optional free-text argument, e.g. the file processed by a job.
+    std::string detail;
+  };
+
+  explicit CTraceRecorder(const std::string& filePath);
+  ~CTraceRecorder();
+
+  CTraceRecorder(const CTraceRecorder&) = delete;
+  CTraceRecorder& operator=(const CTraceRecorder&) = delete;
+
+  //! Returns the nanoseconds elapsed since the creation of the recorder.
+  uint64_t now() const;
+
+  //! Adds an event, the thread index is assigned from the calling thread.
+  void record(SEvent&& event);
+
+  //! Adds an instant event (marker) at the current time.
+  void instant(const char* name, const char* category, const char* argName = nullptr,
+               uint64_t argValue = 0);
+
+ private:
+  //! Appends @p events to the file.
+  void writeEvents(const std::vector<SEvent>& events);
+  //! Writes the remaining events and the thread names and closes the JSON document.
+  void finish();
+
+  const std::string m_filePath;
+  const std::chrono::steady_clock::time_point m_start;
+  std::mutex m_mutex;
+  std::vector<SEvent> m_events;
+  std::map<std::thread::id, uint32_t> m_threadIndices;
+  //! Guards the file, so events can be written without blocking the recording threads.
+  std::mutex m_fileMutex;
+  std::ofstream m_file;
+  bool m_firstEntry = true;
+};
+
+/*!
+ * @brief Scoped span recorded as a complete event on destruction.
+ *
+ * All operations are no-ops if no recorder is given, so spans can stay in the code unconditionally.
+ */
+class CTraceSpan {
+ public:
+  CTraceSpan(CTraceRecorder* recorder, const char* name, const char* category);
+  ~CTraceSpan();
+
+  CTraceSpan(const CTraceSpan&) = delete;
+  CTraceSpan& operator=(const CTraceSpan&) = delete;
+
+  //! Attaches a numeric argument, arguments exceeding CTraceRecorder::MAX_ARGS are ignored.
+  void addArg(const char* name, uint64_t value);
+
+  //! Attaches a free-text argument.
+  void setDetail(const std::string& detail);
+
+ private:
+  CTraceRecorder* m_recorder;
+  CTraceRecorder::SEvent m_event;
+};
+}  // namespace au2mhasconverterlib
+}  // namespace mmt
@@ -0,0 +1,317 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/**
+ * @file allocation_budget.cpp
+ *
+ * @brief Checks the heap allocations per sample of the conversion hot paths against budgets.
+ *
+ * Every hot path converts a synthetic stream twice with the same converter and output objects.
+ * The first pass warms up the reused buffers, the allocations of the second pass are counted per
+ * sample and checked against the budget of the sample kind. The process exits with a failure code
+ * if any budget is exceeded.
+ */
+
+// System includes
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// External includes
+#include "ilo/logging.h"
+#include "mmtisobmff/types.h"
+
+// Internal includes
+#include "mmtau2mhasconverterlib/converter.h"
+#include "mmtau2mhasconverterlib/file_converter.h"
+#include "mmtau2mhasconverterlib/log_redirect.h"
+#include "allocation_counter.h"
+#include "bitstream_builder.h"
+#include "converter_mha.h"
+#include "converter_mhm.h"
+#include "stream_generator.h"
+
+using namespace mmt::au2mhasconverterlib;
+using namespace mmt::au2mhasconverterlib::generator;
+using namespace mmt::au2mhasconverterlib::verification;
+
+//! Budget marking a sample kind whose allocations are only reported.
+static constexpr uint64_t NO_BUDGET = ~uint64_t{0};
+
+//! Allocations of one sample kind of a hot path.
+struct SSampleAllocations {
+  uint64_t samples = 0;
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+  uint64_t maxAllocations = 0;
+};
+
+//! Allocation budgets (maximal allocations per sample) of one hot path.
+struct SBudget {
+  std::string name;
+  uint64_t regularSample = 0;
+  uint64_t ipfSample = NO_BUDGET;
+};
+
+//! A synthetic stream in the input formats of the hot paths.
+struct STestStream {
+  ByteBuffer config;
+  std::vector<SAccessUnit> accessUnits;
+  std::vector<mmt::isobmff::CSample> mhaSamples;
+  std::vector<mmt::isobmff::CSample> mhmSamples;
+};
+
+static STestStream createTestStream() {
+  SStreamConfig streamConfig;
+  streamConfig.numFrames = 500;
+  streamConfig.ipfInterval = 50;
+
+  STestStream stream;
+  CAccessUnitGenerator generator(streamConfig);
+  stream.config = generator.config();
+  SAccessUnit accessUnit;
+  while (generator.next(accessUnit)) {
+    mmt::isobmff::CSample mhaSample;
+    mhaSample.rawData = accessUnit.data;
+    mhaSample.duration = 1024;
+    mhaSample.isSyncSample = accessUnit.isIpf;
+    stream.mhaSamples.push_back(mhaSample);
+
+    mmt::isobmff::CSample mhmSample;
+    mhmSample.rawData = buildMhmSample(accessUnit.isIpf ? stream.config : ByteBuffer{},
+                                       accessUnit.data, accessUnit.isIpf, 1);
+    mhmSample.duration = 1024;
+    mhmSample.isSyncSample = accessUnit.isIpf;
+    stream.mhmSamples.push_back(mhmSample);
+
+    stream.accessUnits.push_back(accessUnit);
+  }
+  return stream;
+}
+
+/*!
+ * @brief Runs @p convert for all samples twice and checks the second pass against @p budget.
+ *
+ * @p convert is called with the sample index within the stream. Returns false if the budget is
+ * exceeded.
+ */
+static bool checkBudget(const SBudget& budget, const std::vector<SAccessUnit>& accessUnits,
+                        const std::function<void(size_t, uint64_t)>& convert) {
+  uint64_t sampleIndex = 0;
+  for (size_t i = 0; i < accessUnits.size(); ++i) {
+    convert(i, sampleIndex++);
+  }
+
+  SSampleAllocations kinds[2];
+  for (size_t i = 0; i < accessUnits.size(); ++i) {
+    const SAllocationCount before = allocationCount();
+    convert(i, sampleIndex++);
+    const SAllocationCount count = allocationsSince(before);
+
+    SSampleAllocations& kind = kinds[accessUnits[i].isIpf ? 1 : 0];
+    ++kind.samples;
+    kind.allocations += count.allocations;
+    kind.bytes += count.bytes;
+    if (count.allocations > kind.maxAllocations) {
+      kind.maxAllocations = count.allocations;
+    }
+  }
+
+  bool passed = true;
+  const char* kindNames[2] = {"regular", "ipf"};
+  const uint64_t budgets[2] = {budget.regularSample, budget.ipfSample};
+  for (size_t k = 0; k < 2; ++k) {
+    const SSampleAllocations& kind = kinds[k];
+    if (kind.samples == 0) {
+      continue;
+    }
+    const bool reportOnly = budgets[k] == NO_BUDGET;
+    const bool kindPassed = reportOnly || kind.maxAllocations <= budgets[k];
+    passed = passed && kindPassed;
+
+    char budgetText[32];
+    if (reportOnly) {
+      std::snprintf(budgetText, sizeof(budgetText), "%s", "-");
+    } else {
+      std::snprintf(budgetText, sizeof(budgetText), "%llu",
+                    static_cast<unsigned long long>(budgets[k]));
+    }
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-32s %-8s %8llu %12.2f %12.1f %8llu %8s  %s\n",
+                  budget.name.c_str(), kindNames[k], static_cast<unsigned long long>(kind.samples),
+                  static_cast<double>(kind.allocations) / static_cast<double>(kind.samples),
+                  static_cast<double>(kind.bytes) / static_cast<double>(kind.samples),
+                  static_cast<unsigned long long>(kind.maxAllocations), budgetText,
+                  reportOnly ? "REPORT" : (kindPassed ? "OK" : "FAILED"));
+    std::cout << line;
+  }
+  return passed;
+}
+
+int main() {
+  // logging would allocate and is not part of the budgets
+  logging::disable();
+
+  bool passed = true;
+  try {
+    const STestStream stream = createTestStream();
+    const CFileConverter::SConfig fileConfig;
+
+    char header[256];
+    std::snprintf(header, sizeof(header), "%-32s %-8s %8s %12s %12s %8s %8s  %s\n", "hot path",
+                  "sample", "samples", "allocs/op", "bytes/op", "max", "budget", "result");
+    std::cout << header;
+
+    {
+      CConverter converter{CConverter::SConverterConfiguration()};
+      converter.convertConfig(stream.config);
+      SMhasFrameOutput output;
+      SBudget budget;
+      budget.name = "CConverter::convertFrame";
+      passed &= checkBudget(budget, stream.accessUnits, [&](size_t i, uint64_t) {
+        converter.convertFrame(stream.accessUnits[i].data, output);
+      });
+    }
+
+    {
+      CConverter converter{CConverter::SConverterConfiguration()};
+      converter.convertConfig(stream.config);
+      SMhasFrameOutput output;
+      SBudget budget;
+      budget.name = "CConverter::tryConvertFrame";
+      passed &= checkBudget(budget, stream.accessUnits, [&](size_t i, uint64_t) {
+        if (converter.tryConvertFrame(stream.accessUnits[i].data, output) !=
+            EConversionStatus::OK) {
+          ILO_FAIL("tryConvertFrame failed for access unit %zu", i);
+        }
+      });
+    }
+
+    {
+      // the by-value overload returns fresh buffers by design
+      CConverter converter{CConverter::SConverterConfiguration()};
+      converter.convertConfig(stream.config);
+      SBudget budget;
+      budget.name = "CConverter::convertFrame (copy)";
+      budget.regularSample = NO_BUDGET;
+      checkBudget(budget, stream.accessUnits, [&](size_t i, uint64_t) {
+        SMhasFrameOutput output = converter.convertFrame(stream.accessUnits[i].data);
+        (void)output;
+      });
+    }
+
+    {
+      auto converter = openMhaConverter(1);
+      SMhasFrameOutput frame;
+      mmt::isobmff::CSample outSample;
+      SBudget budget;
+      budget.name = "convertMhaSampleToMhm";
+      passed &= checkBudget(budget, stream.accessUnits, [&](size_t i, uint64_t sampleIndex) {
+        convertMhaSampleToMhm(fileConfig, *converter, stream.mhaSamples[i], stream.config,
+                              sampleIndex, frame, outSample);
+      });
+    }
+
+    {
+      auto converter = openMhmConverter(1);
+      CMhmSampleCleaner cleaner(fileConfig, *converter);
+      mmt::isobmff::CSample outSample;
+      SBudget budget;
+      budget.name = "CMhmSampleCleaner";
+      passed &= checkBudget(budget, stream.accessUnits, [&](size_t i, uint64_t sampleIndex) {
+        cleaner.clean(stream.mhmSamples[i], sampleIndex, outSample);
+      });
+    }
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!passed) {
+    std::cout << "Allocation budget exceeded" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,476 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/**
+ * @file behavior_check.cpp
+ *
+ * @brief Checks observable behavior of the conversion APIs on generated MP4 files.
+ *
+ * Every check converts generated input files in a work directory and inspects the side effects
+ * visible to a client (callbacks, output files, statistics). The process exits with a failure
+ * code if any check fails.
+ */
+
+// System includes
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#endif
+
+// External includes
+#include "ilo/logging.h"
+
+// Internal includes
+#include "mmtau2mhasconverterlib/async_log_sink.h"
+#include "mmtau2mhasconverterlib/converter.h"
+#include "mmtau2mhasconverterlib/directory_converter.h"
+#include "mmtau2mhasconverterlib/file_converter.h"
+#include "mmtau2mhasconverterlib/log_redirect.h"
+#include "directories.h"
+#include "mp4_generator.h"
+
+using namespace mmt::au2mhasconverterlib;
+using namespace mmt::au2mhasconverterlib::generator;
+
+//! A named check, returning false and describing the failure in @p failure if it fails.
+struct SCheck {
+  std::string name;
+  std::function<bool(const std::string& workDirectory, std::string& failure)> run;
+};
+
+static void printUsage() {
+  std::cout << "Usage: au2mhasbehaviorcheck -o <work directory>" << std::endl;
+}
+
+static std::string workFile(const std::string& workDirectory, const std::string& name) {
+  return workDirectory + CDirectories::getPathSeparator() + name;
+}
+
+static std::string createDirectory(const std::string& workDirectory, const std::string& name) {
+  const std::string path = workFile(workDirectory, name);
+  ILO_ASSERT(CDirectories::createDirectory(path) != CDirectories::ECreateDirectoryReturn::FAILED,
+             "Creating %s failed", path.c_str());
+  return path;
+}
+
+static std::string generateFile(const std::string& workDirectory, const std::string& name,
+                                EContainerFormat format,
+                                const std::vector<uint8_t>& mhapSets = {}) {
+  SStreamConfig streamConfig;
+  streamConfig.numFrames = 200;
+  streamConfig.ipfInterval = 20;
+  SMp4Config mp4Config;
+  mp4Config.outputFile = workFile(workDirectory, name);
+  mp4Config.format = format;
+  mp4Config.profileAndLevelCompatibleSets = mhapSets;
+  writeMp4File(streamConfig, mp4Config);
+  return mp4Config.outputFile;
+}
+
+//! Every emitted event has to result in exactly one record of the asynchronous log sink.
+static bool checkEventRecordsPerEvent(const std::string& workDirectory, std::string& failure) {
+  uint64_t events = 0;
+  uint64_t messages = 0;
+  uint64_t eventRecords = 0;
+  uint64_t messageRecords = 0;
+  {
+    CAsyncLogSink::SConfig sinkConfig;
+    sinkConfig.overflowPolicy = CAsyncLogSink::EOverflowPolicy::BLOCK;
+    sinkConfig.sink = [&](const SLogRecord& record) {
+      ++(record.isEvent ? eventRecords : messageRecords);
+    };
+    CAsyncLogSink sink(sinkConfig);
+
+    const auto logCallback = sink.logCallback(1);
+    const auto eventCallback = sink.eventCallback(1);
+    CFileConverter::SConfig config;
+    config.inputFile = generateFile(workDirectory, "events.mp4", EContainerFormat::MHA1);
+    config.outputFile = workFile(workDirectory, "events_out.mp4");
+    config.eventMask = EVENT_MASK_ALL;
+    config.logCallback = [&](const std::string& message) {
+      ++messages;
+      logCallback(message);
+    };
+    config.eventCallback = [&](const SEvent& event) {
+      ++events;
+      eventCallback(event);
+    };
+    CFileConverter converter(config);
+    converter.process();
+    sink.flush();
+  }
+
+  if (events == 0 || eventRecords != events || messageRecords != messages) {
+    failure = std::to_string(events) + " events and " + std::to_string(messages) +
+              " messages resulted in " + std::to_string(eventRecords) + " event records and " +
+              std::to_string(messageRecords) + " message records";
+    return false;
+  }
+  return true;
+}
+
+//! Producing threads of consecutive batches have to reuse the ring buffers of exited threads.
+static bool checkLogSinkRingsBounded(const std::string& /* workDirectory */,
+                                     std::string& failure) {
+  constexpr size_t NUM_BATCHES = 8;
+  constexpr size_t THREADS_PER_BATCH = 4;
+  constexpr size_t MESSAGES_PER_THREAD = 100;
+
+  uint64_t records = 0;
+  CAsyncLogSink::SConfig sinkConfig;
+  sinkConfig.overflowPolicy = CAsyncLogSink::EOverflowPolicy::BLOCK;
+  sinkConfig.sink = [&](const SLogRecord&) { ++records; };
+  CAsyncLogSink sink(sinkConfig);
+
+  for (size_t batch = 0; batch < NUM_BATCHES; ++batch) {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < THREADS_PER_BATCH; ++i) {
+      const uint64_t jobId = batch * THREADS_PER_BATCH + i;
+      threads.emplace_back([&sink, jobId]() {
+        for (size_t k = 0; k < MESSAGES_PER_THREAD; ++k) {
+          sink.log(jobId, "message " + std::to_string(k));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  sink.flush();
+
+  const uint64_t expectedRecords = NUM_BATCHES * THREADS_PER_BATCH * MESSAGES_PER_THREAD;
+  if (records != expectedRecords) {
+    failure = std::to_string(records) + " of " + std::to_string(expectedRecords) +
+              " records were passed to the sink";
+    return false;
+  }
+  if (sink.ringCount() > THREADS_PER_BATCH) {
+    failure = std::to_string(NUM_BATCHES) + " batches of " + std::to_string(THREADS_PER_BATCH) +
+              " threads allocated " + std::to_string(sink.ringCount()) + " ring buffers";
+    return false;
+  }
+  return true;
+}
+
+//! An IPF whose AudioPreRoll exceeds the frame has to be rejected before it is parsed.
+static bool checkTruncatedIpfRejected(const std::string& /* workDirectory */,
+                                      std::string& failure) {
+  // usacIndependencyFlag, usacExtElementPresent, !usacExtElementUseDefaultLength and a
+  // usacExtElementPayloadLength of 200 bytes
+  const ByteBuffer truncatedIpf = {0xD9, 0x00, 0x00};
+
+  CConverter converter(CConverter::SConverterConfiguration{});
+  SMhasFrameOutput output;
+  SConversionDiagnostics diagnostics;
+  const EConversionStatus status = converter.tryConvertFrame(truncatedIpf, output, &diagnostics);
+  if (status != EConversionStatus::INVALID_BITSTREAM) {
+    failure = "the truncated IPF was not reported as invalid bitstream";
+    return false;
+  }
+  if (diagnostics.parserError != "AudioPreRoll exceeds the frame") {
+    failure = "the truncated IPF was passed to the bit parser: " + diagnostics.parserError;
+    return false;
+  }
+  return true;
+}
+
+#if defined(AU2MHAS_CHECK_INFO_LOGGING)
+//! The internal log messages of directory jobs have to be enqueued in the asynchronous log sink.
+static bool checkInternalLogInSink(const std::string& workDirectory, std::string& failure) {
+  const std::string inputDirectory = createDirectory(workDirectory, "internal_log_in");
+  const std::string outputDirectory = createDirectory(workDirectory, "internal_log_out");
+  generateFile(inputDirectory, "internal_log.mp4", EContainerFormat::MHA1);
+
+  uint64_t internalRecords = 0;
+  {
+    CAsyncLogSink::SConfig sinkConfig;
+    sinkConfig.overflowPolicy = CAsyncLogSink::EOverflowPolicy::BLOCK;
+    sinkConfig.sink = [&](const SLogRecord& record) {
+      // logged by the converter for every IPF
+      if (std::strstr(record.message, " is an IPF. ") != nullptr) {
+        ++internalRecords;
+      }
+    };
+
+    CDirectoryConverter::SConfig config;
+    config.inputDirectoryPath = inputDirectory;
+    config.outputDirectoryPath = outputDirectory;
+    config.asyncLogSink = std::make_shared<CAsyncLogSink>(sinkConfig);
+    CDirectoryConverter converter(config);
+    converter.process();
+    config.asyncLogSink->flush();
+  }
+
+  if (internalRecords == 0) {
+    failure = "no internal log message reached the sink";
+    return false;
+  }
+  return true;
+}
+#endif
+
+//! Returns whether the generated mhm1 file @p inputFile is copied as compliant input.
+static bool isCopiedAsCompliant(const std::string& workDirectory, const std::string& inputFile,
+                                bool copyMhap) {
+  CFileConverter::SConfig config;
+  config.inputFile = inputFile;
+  config.outputFile = workFile(workDirectory, "compliant_probe.mp4");
+  config.compliantMhmHandling = ECompliantInputHandling::COPY;
+  config.copyMhap = copyMhap;
+  CFileConverter converter(config);
+  converter.process();
+  return converter.statistics().compliantInput;
+}
+
+//! Compliant mhm1 samples don't make a file compliant if its 'mhaP' box would change.
+static bool checkCompliantInputWithDifferentMhap(const std::string& workDirectory,
+                                                 std::string& failure) {
+  if (!isCopiedAsCompliant(workDirectory,
+                           generateFile(workDirectory, "no_mhap.mp4", EContainerFormat::MHM1),
+                           false)) {
+    failure = "generated mhm1 input is not compliant";
+    return false;
+  }
+
+  // the converter writes no 'mhaP' box without copyMhap, and the profile level of the config
+  // (never the reserved value 0xFF) with copyMhap
+  const std::string inputFile =
+      generateFile(workDirectory, "mhap.mp4", EContainerFormat::MHM1, std::vector<uint8_t>{0xFF});
+  for (const bool copyMhap : {false, true}) {
+    if (isCopiedAsCompliant(workDirectory, inputFile, copyMhap)) {
+      failure = std::string("input with a different 'mhaP' box was copied (copyMhap ") +
+                (copyMhap ? "on)" : "off)");
+      return false;
+    }
+  }
+  return true;
+}
+
+//! An output that can't be published has to fail its job only, not the whole batch.
+static bool checkUnpublishableOutputFailsJob(const std::string& workDirectory,
+                                             std::string& failure) {
+  const std::string inputDirectory = createDirectory(workDirectory, "unpublishable_in");
+  const std::string outputDirectory = createDirectory(workDirectory, "unpublishable_out");
+  generateFile(inputDirectory, "a.mp4", EContainerFormat::MHA1);
+  generateFile(inputDirectory, "b.mp4", EContainerFormat::MHA1);
+  // a directory in place of the output can't be replaced by the converted file
+  createDirectory(outputDirectory, "a.mp4");
+
+  uint64_t publishErrors = 0;
+  CDirectoryConverter::SConfig config;
+  config.inputDirectoryPath = inputDirectory;
+  config.outputDirectoryPath = outputDirectory;
+  config.addMhmSuffix = false;
+  config.logCallback = [&](const std::string& message) {
+    if (message.find("[E] Publishing") != std::string::npos) {
+      ++publishErrors;
+    }
+  };
+  try {
+    CDirectoryConverter(config).process();
+  } catch (const std::exception& error) {
+    failure = std::string("the batch was aborted: ") + error.what();
+    return false;
+  }
+
+  if (publishErrors != 1) {
+    failure = std::to_string(publishErrors) + " publishing errors were logged instead of 1";
+    return false;
+  }
+  if (!CDirectories::checkFileExists(workFile(outputDirectory, "b.mp4"))) {
+    failure = "the other file of the batch was not converted";
+    return false;
+  }
+  return true;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+static ino_t fileInode(const std::string& path) {
+  struct stat fileStat {};
+  return ::stat(path.c_str(), &fileStat) == 0 ? fileStat.st_ino : 0;
+}
+
+//! Directory jobs copying compliant input must publish the copy without copying it again.
+static bool checkCompliantCopyPublishedOnce(const std::string& workDirectory,
+                                            std::string& failure) {
+  const std::string inputDirectory = createDirectory(workDirectory, "compliant_copy_in");
+  const std::string outputDirectory = createDirectory(workDirectory, "compliant_copy_out");
+  const std::string inputFile =
+      generateFile(inputDirectory, "compliant.mp4", EContainerFormat::MHM1);
+  const std::string outputFile = workFile(outputDirectory, "compliant.mp4");
+
+  if (!isCopiedAsCompliant(workDirectory, inputFile, false)) {
+    failure = "generated mhm1 input is not compliant";
+    return false;
+  }
+
+  // The temporary output of the job has to become the published file (same inode)
+  ino_t temporaryInode = 0;
+  CDirectoryConverter::SConfig config;
+  config.inputDirectoryPath = inputDirectory;
+  config.outputDirectoryPath = outputDirectory;
+  config.addMhmSuffix = false;
+  config.compliantMhmHandling = ECompliantInputHandling::COPY;
+  config.interruptCallback = [&]() {
+    const ino_t inode = fileInode(outputFile + ".tmp");
+    if (inode != 0) {
+      temporaryInode = inode;
+    }
+    return false;
+  };
+  CDirectoryConverter converter(config);
+  converter.process();
+
+  if (!CDirectories::checkFileExists(outputFile) ||
+      CDirectories::getFileSize(outputFile) != CDirectories::getFileSize(inputFile)) {
+    failure = "the input was not copied to " + outputFile;
+    return false;
+  }
+  if (temporaryInode == 0 || fileInode(outputFile) != temporaryInode) {
+    failure = "the copy was copied again when it was published";
+    return false;
+  }
+  return true;
+}
+#endif
+
+int main(int argc, char* argv[]) {
+  std::string workDirectory;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-o" && i + 1 < argc) {
+      workDirectory = argv[++i];
+    } else {
+      printUsage();
+      return EXIT_FAILURE;
+    }
+  }
+  if (workDirectory.empty()) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+
+  logging::disable();
+
+  const std::vector<SCheck> checks = {
+      {"event records per event", checkEventRecordsPerEvent},
+      {"log sink rings bounded", checkLogSinkRingsBounded},
+      {"truncated IPF rejected", checkTruncatedIpfRejected},
+#if defined(AU2MHAS_CHECK_INFO_LOGGING)
+      {"internal log messages in sink", checkInternalLogInSink},
+#endif
+      {"compliant input with different mhaP", checkCompliantInputWithDifferentMhap},
+      {"unpublishable output fails its job", checkUnpublishableOutputFailsJob},
+#if defined(__unix__) || defined(__APPLE__)
+      {"compliant copy published once", checkCompliantCopyPublishedOnce},
+#endif
+  };
+
+  bool passed = true;
+  try {
+    ILO_ASSERT(CDirectories::createDirectory(workDirectory) !=
+                   CDirectories::ECreateDirectoryReturn::FAILED,
+               "Creating %s failed", workDirectory.c_str());
+    for (const auto& check : checks) {
+      std::string failure;
+      const bool checkPassed = check.run(workDirectory, failure);
+      passed = passed && checkPassed;
+      std::cout << (checkPassed ? "OK      " : "FAILED  ") << check.name;
+      if (!checkPassed) {
+        std::cout << ": " << failure;
+      }
+      std::cout << std::endl;
+    }
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,635 @@
+/*-----------------------------------------------------------------------------
+Software License for The Fraunhofer FDK MPEG-H Software
+
+Copyright (c) 2021 - 2024 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. and Contributors
+All rights reserved.
+
+1. INTRODUCTION
+
+The "Fraunhofer FDK MPEG-H Software" is software that implements the ISO/MPEG
+MPEG-H 3D Audio standard for digital audio or related system features. Patent
+licenses for necessary patent claims for the Fraunhofer FDK MPEG-H Software
+(including those of Fraunhofer), for the use in commercial products and
+services, may be obtained from the respective patent owners individually and/or
+from Via LA (www.via-la.com).
+
+Fraunhofer supports the development of MPEG-H products and services by offering
+additional software, documentation, and technical advice. In addition, it
+operates the MPEG-H Trademark Program to ease interoperability testing of end-
+products. Please visit www.mpegh.com for more information.
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted without payment of copyright license fees provided that you
+satisfy the following conditions:
+
+* You must retain the complete text of this software license in redistributions
+of the Fraunhofer FDK MPEG-H Software or your modifications thereto in source
+code form.
+
+* You must retain the complete text of this software license in the
+documentation and/or other materials provided with redistributions of
+the Fraunhofer FDK MPEG-H Software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of
+the Fraunhofer FDK MPEG-H Software and your modifications thereto to recipients
+of copies in binary form.
+
+* The name of Fraunhofer may not be used to endorse or promote products derived
+from the Fraunhofer FDK MPEG-H Software without prior written permission.
+
+* You may not charge copyright license fees for anyone to use, copy or
+distribute the Fraunhofer FDK MPEG-H Software or your modifications thereto.
+
+* Your modified versions of the Fraunhofer FDK MPEG-H Software must carry
+prominent notices stating that you changed the software and the date of any
+change. For modified versions of the Fraunhofer FDK MPEG-H Software, the term
+"Fraunhofer FDK MPEG-H Software" must be replaced by the term "Third-Party
+Modified Version of the Fraunhofer FDK MPEG-H Software".
+
+3. No PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without
+limitation the patents of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE.
+Fraunhofer provides no warranty of patent non-infringement with respect to this
+software. You may use this Fraunhofer FDK MPEG-H Software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+4. DISCLAIMER
+
+This Fraunhofer FDK MPEG-H Software is provided by Fraunhofer on behalf of the
+copyright holders and contributors "AS IS" and WITHOUT ANY EXPRESS OR IMPLIED
+WARRANTIES, including but not limited to the implied warranties of
+merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE
+COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE for any direct, indirect,
+incidental, special, exemplary, or consequential damages, including but not
+limited to procurement of substitute goods or services; loss of use, data, or
+profits, or business interruption, however caused and on any theory of
+liability, whether in contract, strict liability, or tort (including
+negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Audio and Media Technologies - MPEG-H FDK
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+www.iis.fraunhofer.de/amm
+amm-info@iis.fraunhofer.de
+-----------------------------------------------------------------------------*/
+
+/**
+ * @file differential_check.cpp
+ *
+ * @brief Runs the library and the reference engine on the same inputs and compares the outputs.
+ *
+ * Inputs are generated streams (a fixed set of shapes and, optionally, randomized fuzz cases) and
+ * optionally a corpus of MP4 files. For every access unit, the MHAS packets, the packet labels and
+ * the sample flags of both engines have to be byte-identical. Inputs that make one engine fail
+ * have to make the other one fail at the same access unit as well.
+ */
+
+// System includes
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// External includes
+#include "ilo/logging.h"
+#include "mmtisobmff/reader/trackreader.h"
+#include "mmtisobmff/types.h"
+
+// Internal includes
+#include "mmtau2mhasconverterlib/converter.h"
+#include "mmtau2mhasconverterlib/file_converter.h"
+#include "mmtau2mhasconverterlib/log_redirect.h"
+#include "bitstream_builder.h"
+#include "converter_helpers.h"
+#include "converter_mha.h"
+#include "converter_mhm.h"
+#include "directories.h"
+#include "reference_converter.h"
+#include "stream_generator.h"
+
+using namespace mmt::au2mhasconverterlib;
+using namespace mmt::au2mhasconverterlib::generator;
+using namespace mmt::au2mhasconverterlib::verification;
+
+static constexpr uint32_t PACKET_LABEL = 1;
+
+//! Input of one differential case.
+struct STestCase {
+  std::string name;
+  //! The mpegh3daConfig() of the MP4 sample entry in effect for each access unit.
+  std::vector<ByteBuffer> configs;
+  //! The raw mpegh3daFrame() of each access unit.
+  std::vector<ByteBuffer> accessUnits;
+};
+
+//! Outcome of the differential cases run so far.
+struct SCheckResult {
+  uint64_t cases = 0;
+  uint64_t samples = 0;
+  std::vector<std::string> mismatches;
+};
+
+static void printUsage() {
+  std::cout << "Usage: au2mhasdifferentialcheck [options]" << std::endl;
+  std::cout << "Options:" << std::endl;
+  std::cout << "  -f <n>     (Optional) Number of randomized fuzz cases, default 0" << std::endl;
+  std::cout << "  -s <seed>  (Optional) Seed of the first fuzz case, default 1" << std::endl;
+  std::cout << "  -c <dir>   (Optional) Directory with mha1 / mhm1 MP4 files to compare as well"
+            << std::endl;
+}
+
+static std::string describeDifference(const ByteBuffer& reference, const ByteBuffer& actual) {
+  std::ostringstream text;
+  size_t offset = 0;
+  while (offset < reference.size() && offset < actual.size() &&
+         reference[offset] == actual[offset]) {
+    ++offset;
+  }
+  text << "sizes " << reference.size() << " / " << actual.size() << ", first difference at byte "
+       << offset;
+  return text.str();
+}
+
+static bool compareBuffer(const char* field, const ByteBuffer& reference, const ByteBuffer& actual,
+                          std::string& mismatch) {
+  if (reference == actual) {
+    return true;
+  }
+  mismatch = std::string(field) + " differs (" + describeDifference(reference, actual) + ")";
+  return false;
+}
+
+static bool compareOptionalBuffer(const char* field, const std::unique_ptr<ByteBuffer>& reference,
+                                  const std::unique_ptr<ByteBuffer>& actual,
+                                  std::string& mismatch) {
+  if (!reference || !actual) {
+    if (!reference && !actual) {
+      return true;
+    }
+    mismatch = std::string(field) + (reference ? " is missing" : " is unexpectedly present");
+    return false;
+  }
+  return compareBuffer(field, *reference, *actual, mismatch);
+}
+
+static bool compareFrameOutput(const SMhasFrameOutput& reference, const SMhasFrameOutput& actual,
+                               std::string& mismatch) {
+  if (!compareBuffer("frame packet", reference.frame, actual.frame, mismatch) ||
+      !compareOptionalBuffer("config packet", reference.config, actual.config, mismatch) ||
+      !compareOptionalBuffer("asi packet", reference.asi, actual.asi, mismatch)) {
+    return false;
+  }
+  if (reference.isIpf != actual.isIpf || reference.isIndepFrame != actual.isIndepFrame) {
+    mismatch = "isIpf / isIndepFrame flags differ";
+    return false;
+  }
+  return true;
+}
+
+static bool compareSample(const mmt::isobmff::CSample& reference,
+                          const mmt::isobmff::CSample& actual, std::string& mismatch) {
+  if (!compareBuffer("sample data", reference.rawData, actual.rawData, mismatch)) {
+    return false;
+  }
+  if (reference.isSyncSample != actual.isSyncSample) {
+    mismatch = "isSyncSample flag differs";
+    return false;
+  }
+  if (reference.duration != actual.duration || reference.ctsOffset != actual.ctsOffset) {
+    mismatch = "sample timing differs";
+    return false;
+  }
+  return true;
+}
+
+//! Records a mismatch of @p engine in @p testCase at access unit @p index.
+static void addMismatch(SCheckResult& result, const STestCase& testCase, const char* engine,
+                        size_t index, const std::string& mismatch) {
+  std::ostringstream text;
+  text << testCase.name << " [" << engine << "] access unit " << index << ": " << mismatch;
+  result.mismatches.push_back(text.str());
+}
+
+/*!
+ * @brief Runs @p reference and @p actual for each access unit of @p testCase.
+ *
+ * Both return an empty string on success or the error message. The @p compare function is only
+ * called if both succeeded. The case ends at the first mismatch or at the first failure.
+ */
+template <class Reference, class Actual, class Compare>
+static void runEngines(SCheckResult& result, const STestCase& testCase, const char* engine,
+                       Reference&& reference, Actual&& actual, Compare&& compare) {
+  ++result.cases;
+  for (size_t i = 0; i < testCase.accessUnits.size(); ++i) {
+    const std::string referenceError = reference(i);
+    const std::string actualError = actual(i);
+    ++result.samples;
+    if (!referenceError.empty() || !actualError.empty()) {
+      if (referenceError.empty() || actualError.empty()) {
+        addMismatch(result, testCase, engine, i,
+                    referenceError.empty() ? "only the library failed: " + actualError
+                                           : "only the reference failed: " + referenceError);
+      }
+      return;
+    }
+    std::string mismatch;
+    if (!compare(i, mismatch)) {
+      addMismatch(result, testCase, engine, i, mismatch);
+      return;
+    }
+  }
+}
+
+//! Calls @p op and returns the message of an exception thrown by it (or an empty string).
+template <class Op>
+static std::string catchError(Op&& op) {
+  try {
+    op();
+  } catch (const std::exception& error) {
+    return error.what()[0] != '\0' ? error.what() : "unknown error";
+  } catch (...) {
+    return "unknown error";
+  }
+  return std::string();
+}
+
+//! Compares CConverter (both convertFrame overloads) against the reference converter.
+static void checkConverter(SCheckResult& result, const STestCase& testCase) {
+  CConverter::SConverterConfiguration converterConfig;
+  converterConfig.initialPacketLabel = PACKET_LABEL;
+
+  for (bool reuseOutput : {false, true}) {
+    CReferenceConverter referenceConverter(converterConfig);
+    CConverter converter(converterConfig);
+    SMhasConfigOutput referenceConfig;
+    SMhasConfigOutput actualConfig;
+    SMhasFrameOutput referenceFrame;
+    SMhasFrameOutput actualFrame;
+
+    auto reference = [&](size_t i) {
+      return catchError([&] {
+        referenceConfig = referenceConverter.convertConfig(testCase.configs[i]);
+        referenceFrame = referenceConverter.convertFrame(testCase.accessUnits[i]);
+      });
+    };
+    auto actual = [&](size_t i) {
+      return catchError([&] {
+        actualConfig = converter.convertConfig(testCase.configs[i]);
+        if (reuseOutput) {
+          converter.convertFrame(testCase.accessUnits[i], actualFrame);
+        } else {
+          actualFrame = converter.convertFrame(testCase.accessUnits[i]);
+        }
+      });
+    };
+    auto compare = [&](size_t, std::string& mismatch) {
+      if (!compareBuffer("config packet (convertConfig)", referenceConfig.config,
+                         actualConfig.config, mismatch) ||
+          !compareOptionalBuffer("asi packet (convertConfig)", referenceConfig.asi,
+                                 actualConfig.asi, mismatch) ||
+          !compareBuffer("config blob (convertConfig)", referenceConfig.fullMpegHConfigBlob,
+                         actualConfig.fullMpegHConfigBlob, mismatch)) {
+        return false;
+      }
+      if (referenceConfig.compatibleProfileLevel.isSet() !=
+              actualConfig.compatibleProfileLevel.isSet() ||
+          (referenceConfig.compatibleProfileLevel.isSet() &&
+           referenceConfig.compatibleProfileLevel.get() !=
+               actualConfig.compatibleProfileLevel.get())) {
+        mismatch = "compatible profile level differs";
+        return false;
+      }
+      if (!compareFrameOutput(referenceFrame, actualFrame, mismatch)) {
+        return false;
+      }
+      if (referenceConverter.currentPacketLabel() != converter.currentPacketLabel()) {
+        mismatch = "packet label differs";
+        return false;
+      }
+      return true;
+    };
+    runEngines(result, testCase, reuseOutput ? "convertFrame (reuse)" : "convertFrame", reference,
+               actual, compare);
+  }
+}
+
+//! Compares convertMhaSampleToMhm against the reference for all sync packet options.
+static void checkMhaSamples(SCheckResult& result, const STestCase& testCase) {
+  for (uint32_t syncOption = 0; syncOption < 4; ++syncOption) {
+    CFileConverter::SConfig fileConfig;
+    fileConfig.insertSyncBeforeFirstFrame = syncOption == 1;
+    fileConfig.insertSyncBeforeEveryIpf = syncOption == 2;
+    fileConfig.insertSyncBeforeEveryFrame = syncOption == 3;
+
+    CReferenceConverter referenceConverter{CConverter::SConverterConfiguration()};
+    auto converter = openMhaConverter(PACKET_LABEL);
+    mmt::isobmff::CSample inSample;
+    mmt::isobmff::CSample referenceSample;
+    mmt::isobmff::CSample actualSample;
+    SMhasFrameOutput frameScratch;
+
+    auto prepareSample = [&](size_t i) {
+      inSample.rawData = testCase.accessUnits[i];
+      inSample.duration = 1024;
+      inSample.ctsOffset = static_cast<int64_t>(i % 3);
+    };
+    auto reference = [&](size_t i) {
+      prepareSample(i);
+      return catchError([&] {
+        referenceSample = referenceConvertMhaSampleToMhm(fileConfig, referenceConverter, inSample,
+                                                         testCase.configs[i], i == 0);
+      });
+    };
+    auto actual = [&](size_t i) {
+      return catchError([&] {
+        convertMhaSampleToMhm(fileConfig, *converter, inSample, testCase.configs[i], i,
+                              frameScratch, actualSample);
+      });
+    };
+    auto compare = [&](size_t, std::string& mismatch) {
+      if (!compareSample(referenceSample, actualSample, mismatch)) {
+        return false;
+      }
+      if (referenceConverter.currentPacketLabel() != converter->currentPacketLabel()) {
+        mismatch = "packet label differs";
+        return false;
+      }
+      return true;
+    };
+    const char* engines[] = {"convertMhaSampleToMhm", "convertMhaSampleToMhm (sync first)",
+                             "convertMhaSampleToMhm (sync ipf)",
+                             "convertMhaSampleToMhm (sync every)"};
+    runEngines(result, testCase, engines[syncOption], reference, actual, compare);
+  }
+}
+
+//! Compares CMhmSampleCleaner against the reference for the MHM samples @p samples.
+static void checkMhmSamples(SCheckResult& result, const STestCase& testCase,
+                            const std::vector<ByteBuffer>& samples) {
+  const CFileConverter::SConfig fileConfig;
+  CReferenceConverter referenceConverter{CConverter::SConverterConfiguration()};
+  auto converter = openMhmConverter(PACKET_LABEL);
+  CMhmSampleCleaner cleaner(fileConfig, *converter);
+  mmt::isobmff::CSample inSample;
+  mmt::isobmff::CSample referenceSample;
+  mmt::isobmff::CSample actualSample;
+
+  auto reference = [&](size_t i) {
+    inSample.rawData = samples[i];
+    inSample.duration = 1024;
+    return catchError(
+        [&] { referenceSample = referenceCleanMhmSample(referenceConverter, inSample); });
+  };
+  auto actual = [&](size_t i) {
+    return catchError([&] { cleaner.clean(inSample, i, actualSample); });
+  };
+  auto compare = [&](size_t, std::string& mismatch) {
+    if (!compareSample(referenceSample, actualSample, mismatch)) {
+      return false;
+    }
+    if (referenceConverter.currentPacketLabel() != converter->currentPacketLabel()) {
+      mismatch = "packet label differs";
+      return false;
+    }
+    return true;
+  };
+  runEngines(result, testCase, "CMhmSampleCleaner", reference, actual, compare);
+}
+
+//! Runs all engines on @p testCase, the MHM samples are built from the access units.
+static void checkTestCase(SCheckResult& result, const STestCase& testCase) {
+  checkConverter(result, testCase);
+  checkMhaSamples(result, testCase);
+
+  std::vector<ByteBuffer> mhmSamples;
+  for (size_t i = 0; i < testCase.accessUnits.size(); ++i) {
+    const ByteBuffer& accessUnit = testCase.accessUnits[i];
+    const bool isIpf = !accessUnit.empty() && (accessUnit[0] & 0xE0u) == 0xC0u;
+    mhmSamples.push_back(buildMhmSample(isIpf || i == 0 ? testCase.configs[i] : ByteBuffer{},
+                                        accessUnit, isIpf, PACKET_LABEL));
+  }
+  checkMhmSamples(result, testCase, mhmSamples);
+}
+
+static void appendStream(STestCase& testCase, const SStreamConfig& streamConfig) {
+  CAccessUnitGenerator generator(streamConfig);
+  SAccessUnit accessUnit;
+  while (generator.next(accessUnit)) {
+    testCase.configs.push_back(generator.config());
+    testCase.accessUnits.push_back(accessUnit.data);
+  }
+}
+
+//! Returns the fixed set of generated cases.
+static std::vector<STestCase> generatedCases() {
+  struct SNamedShape {
+    const char* name;
+    SConfigShape shape;
+  };
+  std::vector<SNamedShape> shapes(6);
+  shapes[0].name = "channels";
+  shapes[1].name = "objects";
+  shapes[1].shape.numChannelGroups = 0;
+  shapes[1].shape.numObjectGroups = 4;
+  shapes[2].name = "channels+objects";
+  shapes[2].shape.numObjectGroups = 2;
+  shapes[2].shape.objectsPerGroup = 8;
+  shapes[3].name = "many_ext_elements";
+  shapes[3].shape.numExtElements = 32;
+  shapes[3].shape.extElementConfigSize = 32;
+  shapes[4].name = "asi";
+  shapes[4].shape.asiSize = 1024;
+  shapes[5].name = "fill_extensions";
+  shapes[5].shape.numFillConfigExtensions = 3;
+  shapes[5].shape.asiSize = 64;
+
+  std::vector<STestCase> cases;
+  for (const auto& shape : shapes) {
+    for (bool embedConfig : {true, false}) {
+      STestCase testCase;
+      testCase.name = std::string(shape.name) + (embedConfig ? "/embedded_config" : "/dcr_config");
+      SStreamConfig streamConfig;
+      streamConfig.configShape = shape.shape;
+      streamConfig.numFrames = 120;
+      streamConfig.ipfInterval = 25;
+      streamConfig.embedConfigInIpf = embedConfig;
+      appendStream(testCase, streamConfig);
+      cases.push_back(testCase);
+    }
+  }
+
+  // config changes at IPFs rotate the packet label
+  STestCase configChanges;
+  configChanges.name = "config_changes";
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    SStreamConfig streamConfig;
+    streamConfig.configShape = shapes[i].shape;
+    streamConfig.numFrames = 30;
+    streamConfig.ipfInterval = 10;
+    streamConfig.seed = i + 1;
+    appendStream(configChanges, streamConfig);
+  }
+  cases.push_back(configChanges);
+  return cases;
+}
+
+//! Returns a randomized case, equal seeds result in equal cases.
+static STestCase fuzzCase(uint64_t seed) {
+  CRandom random(seed);
+  SStreamConfig streamConfig;
+  streamConfig.seed = seed;
+  streamConfig.numFrames = random.uniform(1, 80);
+  streamConfig.ipfInterval = random.uniform(0, 20);
+  streamConfig.embedConfigInIpf = random.uniform(0, 1) == 1;
+  streamConfig.meanFrameSize = random.uniform(16, 2048);
+  streamConfig.frameSizeJitter = random.uniform(0, streamConfig.meanFrameSize - 8);
+  SConfigShape& shape = streamConfig.configShape;
+  shape.numChannelGroups = random.uniform(0, 3);
+  shape.numObjectGroups = random.uniform(shape.numChannelGroups == 0 ? 1 : 0, 3);
+  shape.objectsPerGroup = random.uniform(1, 8);
+  shape.numExtElements = random.uniform(1, 8);
+  shape.extElementConfigSize = random.uniform(0, 300);
+  shape.asiSize = random.uniform(0, 3) == 0 ? 0 : random.uniform(1, 4000);
+  shape.numFillConfigExtensions = random.uniform(0, 2);
+  shape.fillConfigExtensionSize = random.uniform(0, 64);
+
+  STestCase testCase;
+  testCase.name = "fuzz/seed_" + std::to_string(seed);
+  appendStream(testCase, streamConfig);
+
+  // independent frames without AudioPreRoll
+  for (auto& accessUnit : testCase.accessUnits) {
+    if ((accessUnit[0] & 0xE0u) != 0xC0u && random.uniform(0, 7) == 0) {
+      accessUnit[0] = 0x80u;
+    }
+  }
+  // corrupted bytes, both engines have to fail (or succeed) alike
+  const uint32_t numCorruptions = random.uniform(0, 3) == 0 ? random.uniform(1, 4) : 0;
+  for (uint32_t i = 0; i < numCorruptions; ++i) {
+    ByteBuffer& accessUnit =
+        testCase.accessUnits[random.uniform(0, static_cast<uint32_t>(
+                                                   testCase.accessUnits.size() - 1))];
+    accessUnit[random.uniform(0, static_cast<uint32_t>(accessUnit.size() - 1))] ^=
+        static_cast<uint8_t>(random.uniform(1, 255));
+  }
+  return testCase;
+}
+
+static bool hasSuffix(const std::string& text, const std::string& suffix) {
+  return text.size() >= suffix.size() &&
+         text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+//! Compares the engines on all MP4 files in @p directory.
+static void checkCorpus(SCheckResult& result, const std::string& directory) {
+  for (const auto& file : CDirectories::recursiveDirectorySearch(directory)) {
+    if (!hasSuffix(file, ".mp4") && !hasSuffix(file, ".m4a")) {
+      continue;
+    }
+
+    std::unique_ptr<mmt::isobmff::CIsobmffReader> reader;
+    std::unique_ptr<mmt::isobmff::CMpeghTrackReader> trackReader;
+    try {
+      openReader(file, reader, trackReader);
+    } catch (const std::exception& error) {
+      std::cout << "Skipping " << file << ": " << error.what() << std::endl;
+      continue;
+    }
+
+    STestCase testCase;
+    testCase.name = file;
+    std::vector<ByteBuffer> samples;
+    mmt::isobmff::CSample sample;
+    trackReader->nextSample(sample);
+    while (!sample.empty()) {
+      samples.push_back(sample.rawData);
+      trackReader->nextSample(sample);
+    }
+
+    const mmt::isobmff::Codec codec = reader->trackInfos()[0].codec;
+    if (codec == mmt::isobmff::Codec::mpegh_mha) {
+      const ByteBuffer config = trackReader->mhaDecoderConfigRecord()->mpegh3daConfig();
+      testCase.configs.assign(samples.size(), config);
+      testCase.accessUnits = samples;
+      checkConverter(result, testCase);
+      checkMhaSamples(result, testCase);
+    } else if (codec == mmt::isobmff::Codec::mpegh_mhm) {
+      testCase.accessUnits = samples;
+      checkMhmSamples(result, testCase, samples);
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+  uint64_t numFuzzCases = 0;
+  uint64_t seed = 1;
+  std::string corpusDirectory;
+  for (int i = 1; i < argc; i += 2) {
+    const std::string argument = argv[i];
+    if (argument == "-h" || argument == "--help") {
+      printUsage();
+      return EXIT_SUCCESS;
+    }
+    if (i + 1 >= argc) {
+      std::cout << "Missing value for command line parameter: " << argument << std::endl;
+      printUsage();
+      return EXIT_FAILURE;
+    }
+    try {
+      if (argument == "-f") {
+        numFuzzCases = std::stoull(argv[i + 1]);
+      } else if (argument == "-s") {
+        seed = std::stoull(argv[i + 1]);
+      } else if (argument == "-c") {
+        corpusDirectory = argv[i + 1];
+      } else {
+        std::cout << "Invalid command line parameter: " << argument << std::endl;
+        printUsage();
+        return EXIT_FAILURE;
+      }
+    } catch (const std::exception&) {
+      std::cout << "The value of " << argument << " needs to be numerical, got: " << argv[i + 1]
+                << std::endl;
+      printUsage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  // the engines log every IPF
+  logging::disable();
+
+  SCheckResult result;
+  try {
+    for (const auto& testCase : generatedCases()) {
+      checkTestCase(result, testCase);
+    }
+    for (uint64_t i = 0; i < numFuzzCases; ++i) {
+      checkTestCase(result, fuzzCase(seed + i));
+    }
+    if (!corpusDirectory.empty()) {
+      checkCorpus(result, corpusDirectory);
+    }
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Compared " << result.samples << " access units in " << result.cases << " cases"
+            << std::endl;
+  if (!result.mismatches.empty()) {
+    for (const auto& mismatch : result.mismatches) {
+      std::cout << "MISMATCH " << mismatch << std::endl;
+    }
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}